@@ -54,6 +54,19 @@ TEST_F(BallotTest, GetVotes) {
     EXPECT_EQ(test_ballot.getVotes(), votes);
 }
 
+// Test for getVotesView() method - reads the ballot's votes without a copy
+TEST_F(BallotTest, GetVotesView) {
+    Ballot test_ballot(votes, ballotID);
+    std::span<const int> view = test_ballot.getVotesView();
+    EXPECT_EQ(std::vector<int>(view.begin(), view.end()), votes);
+    EXPECT_EQ(view.data(), test_ballot.getVotesView().data());
+
+    int row[] = {0, 1, 0};
+    Ballot rowView(row, 3, 2);
+    EXPECT_EQ(rowView.getVotesView().data(), row);
+    EXPECT_EQ(rowView.getVotesView().size(), 3);
+}
+
 // Test for getID() method
 TEST_F(BallotTest, GetBallotID) {
     Ballot test_ballot(votes, ballotID);
@@ -63,4 +76,4 @@ TEST_F(BallotTest, GetBallotID) {
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
\ No newline at end of file
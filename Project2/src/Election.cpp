@@ -8,15 +8,28 @@
 
 #include "Election.h"
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <span>
 #include <sstream>
+#include <utility>
 #include <unistd.h>
+#include "approvalmatrix.h"
+#include "auditwriter.h"
+#include "ballotfile.h"
 #include "ballot.h"
+#include "ballotstatus.h"
+#include "ballotstore.h"
+#include "csvparser.h"
 #include "mvballot.h"
+#include "parallel.h"
 #include "pluralityballot.h"
 #include "stvballot.h"
+#include "tallykernel.h"
+#include "trace.h"
 
 // Constructors
 Election::Election(std::vector<std::string> csvFileNames, std::string algorithm,
@@ -24,9 +37,15 @@ Election::Election(std::vector<std::string> csvFileNames, std::string algorithm,
     : csvFileNames(csvFileNames), algorithm(algorithm), numSeats(numSeats),
       auditFileName(auditFileName) {}
 
+// The pointer lists are moved in - the ballots and candidates stay owned by
+// the Election that loaded them
 Election::Election(std::vector<Ballot *> ballots,
                    std::vector<Candidate *> candidates, int numSeats)
-    : ballots(ballots), candidates(candidates), numSeats(numSeats) {}
+    : ballots(std::move(ballots)), candidates(std::move(candidates)),
+      numSeats(numSeats) {
+  for (const Ballot *ballot : this->ballots)
+    numValidBallots += ballot->getWeight();
+}
 
 // Getters
 /*
@@ -56,7 +75,7 @@ std::string Election::getAuditFileName() const { return auditFileName; }
 // Returns the number of seats
 int Election::getNumSeats() const { return numSeats; }
 // Returns the number of ballots
-int Election::getNumBallots() const { return ballots.size(); }
+int Election::getNumBallots() const { return numValidBallots; }
 // Returns the election algorithm type
 std::string Election::getAlgorithm() const { return algorithm; }
 
@@ -73,108 +92,415 @@ std::vector<std::string> Election::getNames() const {
   return names;
 }
 
+namespace {
+
+// Smallest byte range handed to one worker - below this the split is not
+// worth the extra merge work
+constexpr std::size_t minChunkBytes = 1 << 20;
+
+// Valid rows the streaming tally collects before counting them in one go
+constexpr std::size_t tallyBatchRows = 1024;
+
+// Rows of a ballot file copied by one worker at a time
+constexpr std::size_t rowsPerRange = 1 << 16;
+
+// Ballots parsed from one piece of input, merged in input order afterwards
+struct ParsedBallots {
+  std::vector<InvalidBallot> invalidBallots; // votes set once merged
+  std::vector<int> invalidVotes; // votes of each invalid ballot, back to back
+  std::string errors; // invalid ballot messages, printed once merged
+  std::vector<int> voteCounts; // streaming tally - votes per candidate
+  std::vector<int> batch;      // streaming tally - valid rows not counted yet
+  int numValid = 0;            // valid ballots seen
+};
+
+// Streaming tally - counts the collected rows with the column-sum kernel
+void flushTally(std::size_t numCandidates, ParsedBallots &out) {
+  if (numCandidates > 0)
+    tally::countOnes(out.batch.data(), out.batch.size() / numCandidates,
+                     numCandidates, out.voteCounts.data());
+  out.batch.clear();
+}
+
+// Records an invalid row with its reason and the usual error message
+void rejectBallot(const std::vector<int> &votes, BallotStatus status,
+                  int ballotID, ParsedBallots &out) {
+  out.errors += ballotStatusMessage(status, ballotID, votes.data(),
+                                    static_cast<int>(votes.size()));
+  out.errors += '\n';
+  out.invalidBallots.push_back({ballotID, {}, status});
+  out.invalidVotes.insert(out.invalidVotes.end(), votes.begin(), votes.end());
+}
+
+// Streaming tally - validates the row and queues it for the vote counts
+void tallyBallot(const std::vector<int> &votes, BallotType type, int ballotID,
+                 ParsedBallots &out) {
+  BallotStatus status =
+      validateBallot(type, votes.data(), static_cast<int>(votes.size()));
+  if (status != BallotStatus::Valid) {
+    rejectBallot(votes, status, ballotID, out);
+    return;
+  }
+  out.batch.insert(out.batch.end(), votes.begin(), votes.end());
+  if (out.batch.size() >= tallyBatchRows * votes.size())
+    flushTally(votes.size(), out);
+  out.numValid++;
+}
+
+// Parses every ballot line of text, numbering them from ballotID.
+// Valid rows are written to the store, or packed into approvals when given,
+// from row firstRow onwards.
+void parseBallotLines(std::string_view text, BallotType type,
+                      std::size_t numCandidates, int ballotID, bool streaming,
+                      BallotStore &store, ApprovalMatrix *approvals,
+                      std::size_t firstRow, ParsedBallots &out) {
+  std::vector<int> votes;
+  std::size_t pos = 0;
+  std::string_view line;
+  if (streaming) {
+    out.voteCounts.assign(numCandidates, 0);
+    out.batch.reserve(tallyBatchRows * numCandidates);
+  }
+
+  while (csv::nextLine(text, pos, line)) {
+    votes.assign(numCandidates, 0);
+
+    // Parse each vote value (empty or malformed cells stay 0)
+    if (csv::parseRow(line, votes.data(), votes.size()) == 0)
+      continue;
+    if (streaming) {
+      tallyBallot(votes, type, ballotID++, out);
+      continue;
+    }
+    // validate as per election algorithm - a status code, nothing is thrown
+    BallotStatus status =
+        validateBallot(type, votes.data(), static_cast<int>(votes.size()));
+    if (status != BallotStatus::Valid) {
+      // Store invalid ballots separately
+      rejectBallot(votes, status, ballotID, out);
+    } else if (approvals) {
+      // Pack valid ballot into the approval matrix
+      std::size_t row = firstRow + out.numValid++;
+      approvals->setRow(row, votes.data());
+      approvals->setID(row, ballotID);
+    } else if (type != BallotType::None) {
+      // Add valid ballot to the ballot store
+      std::size_t row = firstRow + out.numValid++;
+      std::copy(votes.begin(), votes.end(), store.row(row));
+      store.setID(row, ballotID);
+    }
+    ballotID++;
+  }
+  if (streaming)
+    flushTally(numCandidates, out);
+}
+
+} // namespace
+
+void Election::setNumThreads(int threads) { numThreads = threads; }
+
+void Election::setTallyThreshold(int ballots) { tallyThreshold = ballots; }
+
+void Election::setStreamingTally(bool streaming) { streamingTally = streaming; }
+
+void Election::setGroupBallots(bool grouping) { groupBallots = grouping; }
+
+void Election::setPackedApprovals(bool packed) { packApprovals = packed; }
+
+void Election::setRankColumns(bool columnar) {
+  ballotStore.setRankColumns(columnar);
+}
+
 // Updated setBallots() to handle multiple files
+// Each file is memory-mapped and scanned in place - cells are converted
+// straight from the mapped bytes, so no per-line strings or streams are built.
+// Files are cut into newline-aligned byte ranges that are parsed at the same
+// time on a pool of numThreads workers.
 std::vector<Ballot *> Election::setBallots() {
   ballots.clear();
   invalidBallots.clear();
   candidates.clear(); // Clear any existing candidates
+  // Candidates and invalid ballot votes of an earlier load go in one release
+  arena.release();
+  voteCounts.clear();
+  numValidBallots = 0;
+  ballotStore.reset(0);
+  approvals.reset(0);
 
   if (csvFileNames.empty()) {
     throw std::runtime_error("No CSV files specified");
   }
 
-  // Process first file to get candidates
-  bool firstFile = true;
-  int ballotID = 1;
-
-  for (const auto &fileName : csvFileNames) {
-    std::ifstream file(fileName);
-    if (!file.is_open()) {
-      throw std::runtime_error("Failed to open CSV file: " + fileName);
+  const BallotType type = ballotTypeFor(algorithm);
+  // Only PV and MV results depend on nothing but the per-candidate counts
+  const bool streaming =
+      streamingTally && (type == BallotType::PV || type == BallotType::MV);
+  const bool packed = packApprovals && !streaming &&
+                      (type == BallotType::PV || type == BallotType::MV);
+
+  // Ballot files written by csv2ballot were parsed and validated already
+  if (BallotFile::detect(csvFileNames.front())) {
+    loadBallotFiles(type, streaming, packed);
+    if (packed) {
+      voteCounts = approvals.tally();
+      return ballots;
     }
+    if (groupBallots && !streaming)
+      ballotStore.groupRows();
+    ballots = ballotStore.makeBallots(type);
+    return ballots;
+  }
 
-    std::string line;
+  // Map every file and read its header - candidates come from the first file
+  std::vector<std::unique_ptr<MappedFile>> files;
+  std::vector<std::string_view> ballotSections;
+  for (const auto &fileName : csvFileNames) {
+    if (BallotFile::detect(fileName))
+      throw std::runtime_error("Cannot mix CSV and ballot files: " + fileName);
+    files.push_back(std::make_unique<MappedFile>(fileName));
+    std::string_view text = files.back()->view();
+    std::size_t pos = 0;
+    std::string_view line;
 
     // Read header info (same for all files)
-    std::getline(file, line); // algorithm
-    std::getline(file, line); // num seats
-    std::getline(file, line); // num candidates
-    std::getline(file, line); // num ballots
+    csv::nextLine(text, pos, line); // algorithm
+    csv::nextLine(text, pos, line); // num seats
+    csv::nextLine(text, pos, line); // num candidates
+    csv::nextLine(text, pos, line); // num ballots
+    if (!csv::nextLine(text, pos, line)) // candidate names
+      line = {};
 
     // Only read candidates from first file
-    if (firstFile) {
-      std::getline(file, line); // candidate names
-      std::istringstream iss(line);
-      std::string name;
+    if (files.size() == 1) {
       int candidateID = 0;
-
-      while (std::getline(iss, name, ',')) {
-        candidates.push_back(new Candidate(name, candidateID++));
+      for (const std::string &name : csv::splitNames(line)) {
+        candidates.push_back(arena.make<Candidate>(name, candidateID++));
       }
-      firstFile = false;
-    } else {
-      // Skip candidate names line for subsequent files
-      std::getline(file, line);
-
+    } else if (csv::countCells(line) != candidates.size()) {
       // Verify candidate count matches with candidates vector size
-      std::istringstream iss(line);
-      int candidateCount = 0;
-      while (std::getline(iss, line, ','))
-        candidateCount++;
-
-      if (candidateCount != candidates.size()) {
-        throw std::runtime_error("Candidate count mismatch in file: " +
-                                 fileName);
-      }
+      throw std::runtime_error("Candidate count mismatch in file: " +
+                               fileName);
     }
+    ballotSections.push_back(text.substr(std::min(pos, text.size())));
+    TRACE(trace::Parse, trace::Level::Info,
+          fileName << ": " << text.size() << " bytes, "
+                   << ballotSections.back().size() << " of ballots");
+  }
 
-    // Process ballots from this file
-    while (std::getline(file, line)) {
-      std::vector<int> votes(candidates.size(), 0);
-      std::istringstream ballotStream(line);
-      std::string cell;
-      size_t column = 0;
-      
-      // Parse each vote value
-      while (std::getline(ballotStream, cell, ',')) {
-        try {
-          if (!cell.empty())
-            votes[column] = std::stoi(cell); // Convert to integer
-        } catch (...) {
-          votes[column] = 0;  // Default to 0 for empty cell
-        }
-        column++;
-      }
+  // Split every file into newline-aligned byte ranges, several per worker,
+  // so a single huge file is spread over all threads too
+  std::size_t totalBytes = 0;
+  for (std::string_view section : ballotSections)
+    totalBytes += section.size();
+  const std::size_t workers = parallel::resolveThreads(numThreads);
+  const std::size_t chunkBytes =
+      std::max<std::size_t>(minChunkBytes, totalBytes / (workers * 8));
+  std::vector<std::string_view> chunks;
+  for (std::string_view section : ballotSections) {
+    std::vector<std::string_view> pieces = csv::splitLines(section, chunkBytes);
+    chunks.insert(chunks.end(), pieces.begin(), pieces.end());
+  }
+  TRACE(trace::Parse, trace::Level::Info,
+        totalBytes << " bytes of ballots in " << chunks.size() << " chunks on "
+                   << workers << " threads");
+
+  // Count the ballot rows of every chunk first, so each chunk knows the ID of
+  // its first ballot and IDs match a line-by-line run
+  std::vector<std::size_t> rowCounts(chunks.size());
+  parallel::forEach(chunks.size(), numThreads, [&](std::size_t i) {
+    rowCounts[i] = csv::countRows(chunks[i]);
+  });
+  std::vector<int> firstIDs(chunks.size());
+  std::vector<std::size_t> firstRows(chunks.size());
+  int ballotID = 1;
+  for (std::size_t i = 0; i < chunks.size(); i++) {
+    firstIDs[i] = ballotID;
+    firstRows[i] = ballotID - 1;
+    ballotID += static_cast<int>(rowCounts[i]);
+    TRACE(trace::Parse, trace::Level::Debug,
+          "chunk " << i << ": " << rowCounts[i] << " rows from ballot "
+                   << firstIDs[i]);
+  }
 
-      if (column == 0)
-        continue;
-      // create ballots as per election algorithm
-      try {
-        Ballot *ballot = nullptr;
-        if (algorithm == "STV" || algorithm == "stv") {
-          ballot = new STVBallot(votes, ballotID);
-        } 
-        else if (algorithm == "PV" || algorithm == "pv") {
-          ballot = new PluralityBallot(votes, ballotID);
-        } 
-        else if (algorithm == "MV" || algorithm == "mv") {
-          ballot = new MVBallot(votes, ballotID);
-        }
-        // Add valid ballot to vector of ballots
-        if (ballot)
-          ballots.push_back(ballot);
-      } catch (const std::invalid_argument &e) {
-        // Store invalid ballots separately
-        invalidBallots.emplace_back(ballotID, votes);
-        std::cerr << e.what() << '\n';
-      }
-      ballotID++;
+  // Every chunk owns a block of rows in the store, big enough for all of its
+  // lines - invalid lines leave gaps that are closed afterwards
+  ballotStore.reset(candidates.size());
+  if (packed) {
+    approvals.reset(candidates.size());
+    approvals.resize(ballotID - 1);
+  } else if (!streaming) {
+    ballotStore.resize(ballotID - 1);
+  }
+
+  // Parse the chunks in parallel, each into its own block
+  std::vector<ParsedBallots> parsed(chunks.size());
+  parallel::forEach(chunks.size(), numThreads, [&](std::size_t i) {
+    parseBallotLines(chunks[i], type, candidates.size(), firstIDs[i],
+                     streaming, ballotStore, packed ? &approvals : nullptr,
+                     firstRows[i], parsed[i]);
+  });
+
+  // Stitch the buffers together in file order
+  std::vector<std::size_t> validRows(chunks.size());
+  if (streaming)
+    voteCounts.assign(candidates.size(), 0);
+  for (std::size_t i = 0; i < parsed.size(); i++) {
+    ParsedBallots &part = parsed[i];
+    const std::span<const int> votes(part.invalidVotes);
+    for (std::size_t k = 0; k < part.invalidBallots.size(); k++) {
+      InvalidBallot invalid = part.invalidBallots[k];
+      invalid.votes = arena.copy(
+          votes.subspan(k * candidates.size(), candidates.size()));
+      invalidBallots.push_back(invalid);
     }
-    file.close();
+    std::cerr << part.errors;
+    for (std::size_t c = 0; c < part.voteCounts.size(); c++)
+      voteCounts[c] += part.voteCounts[c];
+    numValidBallots += part.numValid;
+    validRows[i] = streaming ? 0 : part.numValid;
   }
+  TRACE(trace::Parse, trace::Level::Info,
+        numValidBallots << " valid and " << invalidBallots.size()
+                        << " invalid ballots");
+
+  // Packed ballots are counted right away, no views are built
+  if (packed) {
+    approvals.compact(firstRows, validRows);
+    voteCounts = approvals.tally();
+    return ballots;
+  }
+
+  // Close the gaps and build the ballot views over the store
+  ballotStore.compact(firstRows, validRows);
+  if (groupBallots && !streaming)
+    ballotStore.groupRows();
+  ballots = ballotStore.makeBallots(type);
   return ballots;
 }
 
+// Rows are copied out of the mapped files in fixed-size ranges on the worker
+// threads, widened to ints on the way - nothing is parsed again. The rows are
+// still checked against the ballot rules, since the file may have been
+// changed after csv2ballot wrote it, and a bad row rejects the whole file.
+// IDs carry on from one file to the next as they do for CSV files.
+void Election::loadBallotFiles(BallotType type, bool streaming, bool packed) {
+  std::vector<std::unique_ptr<BallotFile>> files;
+  std::size_t totalValid = 0;
+  for (const auto &fileName : csvFileNames) {
+    if (!BallotFile::detect(fileName))
+      throw std::runtime_error("Cannot mix CSV and ballot files: " + fileName);
+    files.push_back(std::make_unique<BallotFile>(fileName));
+    const BallotFile &file = *files.back();
+    if (ballotTypeFor(file.algorithm()) != type)
+      throw std::runtime_error("Ballot file " + fileName + " holds " +
+                               file.algorithm() + " ballots");
+    if (files.size() == 1) {
+      int candidateID = 0;
+      for (const std::string &name : file.names())
+        candidates.push_back(arena.make<Candidate>(name, candidateID++));
+    } else if (file.numCandidates() != candidates.size()) {
+      throw std::runtime_error("Candidate count mismatch in file: " +
+                               fileName);
+    }
+    totalValid += file.numValid();
+    TRACE(trace::Parse, trace::Level::Info,
+          fileName << ": " << file.numValid() << " valid and "
+                   << file.numInvalid() << " invalid ballots, "
+                   << file.voteBytes() << " bytes per vote");
+  }
+
+  const std::size_t width = candidates.size();
+  ballotStore.reset(width);
+  if (packed) {
+    approvals.reset(width);
+    approvals.resize(totalValid);
+  } else if (!streaming) {
+    ballotStore.resize(totalValid);
+  }
+
+  // Ranges of valid rows, and the invalid ballots kept for the audit
+  struct Range {
+    const BallotFile *file;
+    const std::string *fileName;
+    std::size_t first;  // First row in the file
+    std::size_t count;  // Rows in the range
+    std::size_t row;    // First row in the store
+    int idOffset;       // Added to the IDs of the file
+  };
+  std::vector<Range> ranges;
+  std::size_t row = 0;
+  int idOffset = 0;
+  for (std::size_t f = 0; f < files.size(); f++) {
+    const auto &file = files[f];
+    for (std::size_t first = 0; first < file->numValid();
+         first += rowsPerRange) {
+      std::size_t count = std::min(rowsPerRange, file->numValid() - first);
+      ranges.push_back({file.get(), &csvFileNames[f], first, count, row + first,
+                        idOffset});
+    }
+    for (std::size_t i = 0; i < file->numInvalid(); i++) {
+      InvalidBallot invalid = file->invalidBallot(i);
+      invalid.ballotID += idOffset;
+      invalid.votes = arena.copy(invalid.votes);
+      std::cerr << ballotStatusMessage(invalid.reason, invalid.ballotID,
+                                       invalid.votes.data(),
+                                       static_cast<int>(invalid.votes.size()))
+                << '\n';
+      invalidBallots.push_back(invalid);
+    }
+    row += file->numValid();
+    idOffset += static_cast<int>(file->numValid() + file->numInvalid());
+  }
+
+  // Throws unless every one of count rows follows the rules of the type
+  auto checkRows = [&](const Range &range, const int *rows, std::size_t count) {
+    for (std::size_t r = 0; r < count; r++)
+      if (validateBallot(type, rows + r * width, static_cast<int>(width)) !=
+          BallotStatus::Valid)
+        throw std::runtime_error("Invalid ballot file: " + *range.fileName);
+  };
+
+  std::vector<ParsedBallots> parsed(streaming ? ranges.size() : 0);
+  parallel::forEach(ranges.size(), numThreads, [&](std::size_t i) {
+    const Range &range = ranges[i];
+    if (streaming) {
+      // Only the vote counts are kept
+      ParsedBallots &out = parsed[i];
+      out.voteCounts.assign(width, 0);
+      out.batch.resize(range.count * width);
+      range.file->readVotes(range.first, range.count, out.batch.data());
+      checkRows(range, out.batch.data(), range.count);
+      flushTally(width, out);
+      return;
+    }
+    std::vector<int> ids(range.count);
+    range.file->readIDs(range.first, range.count, ids.data());
+    if (packed) {
+      std::vector<int> votes(width);
+      for (std::size_t r = 0; r < range.count; r++) {
+        range.file->readVotes(range.first + r, 1, votes.data());
+        checkRows(range, votes.data(), 1);
+        approvals.setRow(range.row + r, votes.data());
+        approvals.setID(range.row + r, ids[r] + range.idOffset);
+      }
+      return;
+    }
+    range.file->readVotes(range.first, range.count,
+                          ballotStore.row(range.row));
+    checkRows(range, ballotStore.row(range.row), range.count);
+    for (std::size_t r = 0; r < range.count; r++)
+      ballotStore.setID(range.row + r, ids[r] + range.idOffset);
+  });
+
+  if (streaming) {
+    voteCounts.assign(width, 0);
+    for (const ParsedBallots &part : parsed)
+      for (std::size_t c = 0; c < width; c++)
+        voteCounts[c] += part.voteCounts[c];
+  }
+  numValidBallots = static_cast<int>(totalValid);
+}
+
 /*
 //Ballots processing method - for single csv file input
 std::vector<Ballot *> Election::setBallots() {
@@ -244,176 +570,179 @@ std::vector<Ballot *> Election::setBallots() {
 */
 
 
-// Results handling
-std::string Election::generateResultsText() const {
-  std::stringstream ss;
+// Results handling - written straight to the stream, so nothing here grows
+// with the number of ballots
+void Election::writeResults(std::ostream &out) const {
+  writeResultsHeader(out);
+  writeResultsOutcome(out);
+}
 
-  ss << "\n=== Election Results ===" << std::endl;
-  ss << "Election Type: " << algorithm << std::endl;
+// Everything known once the ballots are loaded: ballot counts, the removed
+// ballots and the quota
+void Election::writeResultsHeader(std::ostream &out) const {
+  out << "\n=== Election Results ===" << '\n';
+  out << "Election Type: " << algorithm << '\n';
 
+  // Meek STV shares the STV layout, its quota moves as ballots exhaust so
+  // the Droop quota line is left out
+  const bool meek = algorithm == "MEEK";
   if (algorithm == "PV") {
-    ss << "\n####### PV Results #######" << std::endl;
-    ss << "Number of Invalid Ballots: " << invalidBallots.size() << std::endl;
-
-    // display the invalid ballots
-    if (!invalidBallots.empty()) {
-      ss << "\n\n=== List of Removed Ballots ===";
-      for (const auto &[id, votes] : invalidBallots) {
-        ss << "\nID " << id << ": ";
-        for (int v : votes)
-          ss << v << " ";
-      }
-      ss << std::endl;
-      ss << std::endl;
-    }
-
-    ss << "Number of Valid Ballots: " << ballots.size() << std::endl;
-    ss << "Number of Seats: " << numSeats << std::endl;
-    ss << "Number of Candidates: " << candidates.size() << std::endl;
-
-    // if there are no valid ballots, abort election
-    if (ballots.empty()) {
-      ss << std::endl
-         << "ERROR: Election aborted. No valid ballots to process."
-         << std::endl;
-      return ss.str();
-    }
-
-    // Display winners for PV
-    ss << "\nWinners:" << std::endl;
-    for (const Candidate *winner : winners) {
-      double percentage =
-          (static_cast<double>(winner->getNumVotes()) / ballots.size()) * 100;
-      ss << "  " << winner->getName() << " | Votes: " << winner->getNumVotes()
-         << " | Percentage: " << std::fixed << std::setprecision(2)
-         << percentage << "%" << std::endl;
-    }
-
-    // Display losers for PV
-    ss << "\nLosers:" << std::endl;
-    for (const Candidate *loser : losers) {
-      double percentage =
-          (static_cast<double>(loser->getNumVotes()) / ballots.size()) * 100;
-      ss << "  " << loser->getName() << " | Votes: " << loser->getNumVotes()
-         << " | Percentage: " << std::fixed << std::setprecision(2)
-         << percentage << "%" << std::endl;
+    out << "\n####### PV Results #######" << '\n';
+  } else if (algorithm == "STV" || meek) {
+    out << (meek ? "\n####### Meek STV Results #######"
+                 : "\n####### STV Results #######")
+        << '\n';
+  } else if (algorithm == "MV") {
+    out << "\n####### MV Results #######" << '\n';
+  } else {
+    return;
+  }
+  out << "Number of Invalid Ballots: " << invalidBallots.size() << '\n';
+
+  // display the invalid ballots
+  if (!invalidBallots.empty()) {
+    out << "\n\n=== List of Removed Ballots ===";
+    for (const InvalidBallot &invalid : invalidBallots) {
+      out << "\nID " << invalid.ballotID << ": ";
+      for (int v : invalid.votes)
+        out << v << " ";
     }
-  } else if (algorithm == "STV") {
-
-    // Calculate Droop quota for STV
-    int droopQuota = (ballots.size() / (numSeats + 1)) + 1;
+    out << '\n';
+    out << '\n';
+  }
 
-    ss << "\n####### STV Results #######" << std::endl;
-    ss << "Number of Invalid Ballots: " << invalidBallots.size() << std::endl;
+  out << "Number of Valid Ballots: " << numValidBallots << '\n';
+  out << "Number of Seats: " << numSeats << '\n';
+  out << "Number of Candidates: " << candidates.size() << '\n';
 
-    // display the invalid ballots
-    if (!invalidBallots.empty()) {
-      ss << "\n\n=== List of Removed Ballots ===";
-      for (const auto &[id, votes] : invalidBallots) {
-        ss << "\nID " << id << ": ";
-        for (int v : votes)
-          ss << v << " ";
-      }
-      ss << std::endl;
-      ss << std::endl;
-    }
+  // if there are no valid ballots, abort election
+  if (numValidBallots == 0) {
+    out << '\n'
+        << "ERROR: Election aborted. No valid ballots to process."
+        << '\n';
+    return;
+  }
 
-    ss << "Number of Valid Ballots: " << ballots.size() << std::endl;
-    ss << "Number of Seats: " << numSeats << std::endl;
-    ss << "Number of Candidates: " << candidates.size() << std::endl;
+  // Calculate Droop quota for STV
+  if (algorithm == "STV")
+    out << "Droop Quota: " << (numValidBallots / (numSeats + 1)) + 1
+        << " votes" << '\n';
+}
 
-    // if there are no valid ballots, abort election
-    if (ballots.empty()) {
-      ss << std::endl
-         << "ERROR: Election aborted. No valid ballots to process."
-         << std::endl;
-      return ss.str();
-    }
+// Winners and losers, once the count is done
+void Election::writeResultsOutcome(std::ostream &out) const {
+  const bool known = algorithm == "PV" || algorithm == "STV" ||
+                     algorithm == "MEEK" || algorithm == "MV";
+  // The header already reported the aborted election
+  if (known && numValidBallots == 0)
+    return;
 
-    ss << "Droop Quota: " << droopQuota << " votes" << std::endl;
+  if (algorithm == "STV" || algorithm == "MEEK") {
+    const bool meek = algorithm == "MEEK";
+    int droopQuota = (numValidBallots / (numSeats + 1)) + 1;
 
     // Display winners and whether they met the quota
-    ss << "\nWinners:" << std::endl;
+    out << "\nWinners:" << '\n';
     for (const Candidate *winner : winners) {
       double percentage =
-          (static_cast<double>(winner->getNumVotes()) / ballots.size()) * 100;
+          (static_cast<double>(winner->getNumVotes()) / numValidBallots) * 100;
       bool metQuota = (winner->getNumVotes() >= droopQuota);
 
-      ss << "  " << winner->getName() << " | Votes: " << winner->getNumVotes()
-         << " | Percentage: " << std::fixed << std::setprecision(2)
-         << percentage << "%" << " | Met Quota: " << (metQuota ? "Yes" : "No")
-         << std::endl;
+      out << "  " << winner->getName() << " | Votes: " << winner->getNumVotes()
+          << " | Percentage: " << std::fixed << std::setprecision(2)
+          << percentage << "%";
+      if (!meek)
+        out << " | Met Quota: " << (metQuota ? "Yes" : "No");
+      out << '\n';
     }
 
     // Display losers
-    ss << "\nLosers:" << std::endl;
+    out << "\nLosers:" << '\n';
     for (const Candidate *loser : losers) {
       double percentage =
-          (static_cast<double>(loser->getNumVotes()) / ballots.size()) * 100;
-      ss << "  " << loser->getName() << " | Votes: " << loser->getNumVotes()
-         << " | Percentage: " << std::fixed << std::setprecision(2)
-         << percentage << "%" << std::endl;
-    }
-  } else if (algorithm == "MV") {
-    ss << "\n####### MV Results #######" << std::endl;
-    ss << "Number of Invalid Ballots: " << invalidBallots.size() << std::endl;
-
-    // display the invalid ballots
-    if (!invalidBallots.empty()) {
-      ss << "\n\n=== List of Removed Ballots ===";
-      for (const auto &[id, votes] : invalidBallots) {
-        ss << "\nID " << id << ": ";
-        for (int v : votes)
-          ss << v << " ";
-      }
-      ss << std::endl;
-      ss << std::endl;
+          (static_cast<double>(loser->getNumVotes()) / numValidBallots) * 100;
+      out << "  " << loser->getName() << " | Votes: " << loser->getNumVotes()
+          << " | Percentage: " << std::fixed << std::setprecision(2)
+          << percentage << "%" << '\n';
     }
 
-    ss << "Number of Valid Ballots: " << ballots.size() << std::endl;
-    ss << "Number of Seats: " << numSeats << std::endl;
-    ss << "Number of Candidates: " << candidates.size() << std::endl;
-
-    // if there are no valid ballots, abort election
-    if (ballots.empty()) {
-      ss << std::endl
-         << "ERROR: Election aborted. No valid ballots to process."
-         << std::endl;
-      return ss.str();
+    // Candidates that batch elimination took out in the same round
+    bool together = false;
+    for (const auto &round : eliminationRounds)
+      together = together || round.size() > 1;
+    if (together) {
+      out << "\nEliminated Together:" << '\n';
+      for (std::size_t r = 0; r < eliminationRounds.size(); r++) {
+        if (eliminationRounds[r].size() < 2)
+          continue;
+        out << "  Elimination round " << (r + 1) << ":";
+        for (std::size_t i = 0; i < eliminationRounds[r].size(); i++)
+          out << (i ? ", " : " ") << eliminationRounds[r][i]->getName();
+        out << '\n';
+      }
     }
-
-    // Display winners for Plurality
-    ss << "\nWinners:" << std::endl;
+  } else if (known) {
+    // Display winners for PV and MV
+    out << "\nWinners:" << '\n';
     for (const Candidate *winner : winners) {
       double percentage =
-          (static_cast<double>(winner->getNumVotes()) / ballots.size()) * 100;
-      ss << "  " << winner->getName() << " | Votes: " << winner->getNumVotes()
-         << " | Percentage: " << std::fixed << std::setprecision(2)
-         << percentage << "%" << std::endl;
+          (static_cast<double>(winner->getNumVotes()) / numValidBallots) * 100;
+      out << "  " << winner->getName() << " | Votes: " << winner->getNumVotes()
+          << " | Percentage: " << std::fixed << std::setprecision(2)
+          << percentage << "%" << '\n';
     }
 
-    // Display losers for Plurality
-    ss << "\nLosers:" << std::endl;
+    // Display losers for PV and MV
+    out << "\nLosers:" << '\n';
     for (const Candidate *loser : losers) {
       double percentage =
-          (static_cast<double>(loser->getNumVotes()) / ballots.size()) * 100;
-      ss << "  " << loser->getName() << " | Votes: " << loser->getNumVotes()
-         << " | Percentage: " << std::fixed << std::setprecision(2)
-         << percentage << "%" << std::endl;
+          (static_cast<double>(loser->getNumVotes()) / numValidBallots) * 100;
+      out << "  " << loser->getName() << " | Votes: " << loser->getNumVotes()
+          << " | Percentage: " << std::fixed << std::setprecision(2)
+          << percentage << "%" << '\n';
     }
   }
 
-  ss << "\n=== End of Results ===" << std::endl;
-  return ss.str();
+  out << "\n=== End of Results ===" << '\n';
 }
 
 void Election::displayResults() const {
-  // Displays election results to the console
-  std::cout << generateResultsText();
-  printToAudit();
+  // Displays election results to the console; the audit file gets the same
+  // text from its writer thread, the caller only waits for it to finish
+  {
+    AuditWriter console("", &std::cout);
+    writeResults(console.stream());
+  }
+  finishAudit();
+}
+
+void Election::printToAudit() const { finishAudit(); }
+
+// The header goes to the writer thread right away, so the removed-ballot
+// listing is written while the ballots are counted
+void Election::beginAudit() const {
+  if (audit)
+    return;
+  auditPath = auditFilePath();
+  audit = std::make_unique<AsyncAuditWriter>(auditPath);
+  audit->queue([this](std::ostream &out) { writeResultsHeader(out); });
+}
+
+void Election::finishAudit() const {
+  beginAudit();
+  audit->queue([this](std::ostream &out) { writeResultsOutcome(out); });
+  const bool opened = audit->isOpen();
+  std::unique_ptr<AsyncAuditWriter> writer = std::move(audit);
+  writer->finish();
+  if (!opened) {
+    throw std::runtime_error("Failed to create audit file: " + auditPath);
+  }
+
+  // Debug output to confirm file creation
+  std::cout << "Audit log written to: " << auditPath << std::endl;
 }
 
-void Election::printToAudit() const {
+std::string Election::auditFilePath() const {
   // Get the current working directory
   char cwd[1024];
   if (getcwd(cwd, sizeof(cwd)) == nullptr) {
@@ -435,12 +764,8 @@ void Election::printToAudit() const {
   std::string auditFilePath =
       srcDir + "\\src\\" + fileName; 
 
-  // Open the file in the src folder
-  std::ofstream auditStream(auditFilePath);
-  if (!auditStream) {
-    throw std::runtime_error("Failed to create audit file: " +
-    auditFilePath);
-  }
+  // Opened in the src folder by beginAudit()
+  return auditFilePath;
 
   // FOR LINUX
   /*
@@ -461,25 +786,117 @@ void Election::printToAudit() const {
   if (!auditStream) {
     throw std::runtime_error("Failed to create audit file: " + auditFilePath);
   } */
-  
-  // Write the results to the file
-  auditStream << generateResultsText();
-  auditStream.close();
+}
 
-  // Debug output to confirm file creation
-  std::cout << "Audit log written to: " << auditFilePath << std::endl;
+namespace {
+
+// Ints per cache line - shard histograms are padded to whole lines
+constexpr std::size_t countsPerLine = 64 / sizeof(int);
+
+// Counts the ballots in [first, last) into counts
+void countRange(Ballot *const *first, Ballot *const *last, int *counts) {
+  for (; first != last; ++first) {
+    std::span<const int> votes = (*first)->getVotesView();
+    const int weight = (*first)->getWeight();
+    for (size_t i = 0; i < votes.size(); i++) {
+      if (votes[i] == 1) {
+        counts[i] += weight;
+      }
+    }
+  }
+}
+
+} // namespace
+
+// Tally pass shared by Plurality and MV
+void Election::countVotes(const std::vector<Ballot *> &ballots,
+                          std::vector<int> &voteCounts) {
+  countRange(ballots.data(), ballots.data() + ballots.size(),
+             voteCounts.data());
+}
+
+// Sharded tally - one histogram per shard, each starting on its own cache
+// line so workers never write to a line another worker is writing to
+void Election::tallyVotes(const std::vector<Ballot *> &ballots,
+                          std::vector<int> &voteCounts) const {
+  const std::size_t shards = std::min<std::size_t>(
+      parallel::resolveThreads(numThreads),
+      ballots.size() / std::max(1, tallyThreshold));
+  if (shards <= 1) {
+    countVotes(ballots, voteCounts);
+    return;
+  }
+
+  const std::size_t numCandidates = voteCounts.size();
+  const std::size_t stride =
+      (numCandidates + countsPerLine - 1) / countsPerLine * countsPerLine;
+  std::vector<int> buffer(shards * stride + countsPerLine, 0);
+  int *histograms = buffer.data();
+  while (reinterpret_cast<std::uintptr_t>(histograms) % 64 != 0)
+    histograms++;
+
+  parallel::forEach(shards, numThreads, [&](std::size_t shard) {
+    const std::size_t first = ballots.size() * shard / shards;
+    const std::size_t last = ballots.size() * (shard + 1) / shards;
+    countRange(ballots.data() + first, ballots.data() + last,
+               histograms + shard * stride);
+  });
+
+  for (std::size_t shard = 0; shard < shards; shard++)
+    for (std::size_t c = 0; c < numCandidates; c++)
+      voteCounts[c] += histograms[shard * stride + c];
+}
+
+// Same tally straight over the store - the rows are one matrix, so the SIMD
+// column-sum kernel can run down them when every weight is 1
+void Election::countVotes(const BallotStore &store,
+                          std::vector<int> &voteCounts) {
+  if (store.grouped()) {
+    for (std::size_t row = 0; row < store.size(); row++) {
+      const int *votes = store.row(row);
+      for (std::size_t i = 0; i < store.width(); i++)
+        if (votes[i] == 1)
+          voteCounts[i] += store.weight(row);
+    }
+    return;
+  }
+  tally::countOnes(store.row(0), store.size(), store.width(),
+                   voteCounts.data());
 }
 
 // Remaining methods
+// One line per ballot, so Debug only
 void Election::displayBallotAllocation() const {
-  // Displays the allocation of votes for each ballot (for testing)
-  std::cout << "Ballot Allocation:\n";
-  for (const Ballot *b : ballots) {
-    std::cout << "Ballot ID: " << b->getID() << ", Votes: ";
-    for (int v : b->getVotes())
-      std::cout << v << " ";
-    std::cout << "\n";
+  if (!trace::enabled(trace::Ballot, trace::Level::Debug))
+    return;
+  auto line = [](int id, auto votes) {
+    std::ostringstream text;
+    text << "ballot " << id << " ->";
+    for (auto v : votes)
+      text << ' ' << v;
+    trace::write(trace::Ballot, text.str());
+  };
+  // Packed ballots have no Ballot objects, write their bits
+  if (approvals.size() > 0) {
+    std::vector<int> bits(approvals.width());
+    for (std::size_t row = 0; row < approvals.size(); row++) {
+      for (std::size_t c = 0; c < approvals.width(); c++)
+        bits[c] = approvals.test(row, c);
+      line(approvals.id(row), bits);
+    }
+    return;
   }
+  // Grouped ballots are listed once per ballot ID they stand for
+  if (ballotStore.grouped()) {
+    for (std::size_t row = 0; row < ballotStore.size(); row++) {
+      std::span<const int> votes(ballotStore.row(row), ballotStore.width());
+      for (int id : ballotStore.members(row))
+        line(id, votes);
+    }
+    return;
+  }
+  for (const Ballot *b : ballots)
+    line(b->getID(), b->getVotesView());
 }
 
 void Election::addWinner(Candidate *candidate) {
@@ -494,6 +911,10 @@ void Election::addLoser(Candidate *candidate) {
   candidate->setLoser(true);
 }
 
+void Election::addEliminationRound(const std::vector<Candidate *> &round) {
+  eliminationRounds.push_back(round);
+}
+
 std::vector<Candidate *> Election::getPluralityResults() const {
   // Returns candidates sorted by votes in descending order (for Plurality
   // elections)
@@ -9,8 +9,15 @@
 #ifndef ELECTION_H
 #define ELECTION_H
 
+#include "approvalmatrix.h"
+#include "arena.h"
+#include "auditwriter.h"
 #include "ballot.h"
+#include "ballotstatus.h"
+#include "ballotstore.h"
 #include "candidate.h"
+#include <iosfwd>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -22,23 +29,63 @@
 class Election {
 protected:
     int numSeats;
-    std::vector<Ballot*> ballots;
+    std::vector<Ballot*> ballots; // Views into ballotStore when loaded by setBallots
     //std::string csvFileName;
     std::string algorithm;
     mutable std::string auditFileName; // No longer const
-    std::vector<Candidate*> candidates;
+    std::vector<Candidate*> candidates; // Owned by arena when loaded by setBallots
     std::vector<Candidate*> winners;
     std::vector<Candidate*> losers;
-    std::vector<std::pair<int, std::vector<int>>> invalidBallots; // Stores (ballotID, votes)
+    std::vector<std::vector<Candidate*>> eliminationRounds; // STV: candidates eliminated in each round
+    std::vector<InvalidBallot> invalidBallots; // Stores (ballotID, votes, reason), votes in arena
     std::vector<std::string> csvFileNames;  // Replace csvFileName with this
 
     std::vector<std::string> errorLogs; 
+    int numThreads = 0; // Worker threads for loading and counting ballots, 0 = one per core
+    int tallyThreshold = 1 << 16; // Fewest ballots tallyVotes splits across threads
+    bool streamingTally = false; // PV/MV: count votes while loading instead of keeping ballots
+    std::vector<int> voteCounts; // Votes per candidate counted by the streaming loader
+    int numValidBallots = 0;     // Valid ballots, also counted when none are kept
+    bool groupBallots = false;   // Merge identical ballots into weighted groups
+    bool packApprovals = false;  // PV/MV: keep ballots as bit masks instead of Ballot objects
+    BallotStore ballotStore;     // Owns the votes of every ballot loaded by setBallots
+    ApprovalMatrix approvals;    // Packed PV/MV ballots loaded with packApprovals on
+    Arena arena;                 // Owns the candidates and invalid ballot votes of setBallots
     
     // Helper to generate results text
     /**
      * @brief Helper function for generating election results 
+     * The report is written section by section straight to out.
+     * @param out stream receiving the report
      */
-    std::string generateResultsText() const;
+    void writeResults(std::ostream& out) const;
+    /**
+     * @brief writes the part of the results known once ballots are loaded
+     * @param out stream receiving the ballot counts, removed ballots and quota
+     */
+    void writeResultsHeader(std::ostream& out) const;
+    /**
+     * @brief writes the winners and losers
+     * @param out stream receiving the rest of the results
+     */
+    void writeResultsOutcome(std::ostream& out) const;
+    /**
+     * @brief queues the results outcome, waits for the audit file and reports it
+     * @throws std::runtime_error if the audit file could not be written
+     */
+    void finishAudit() const;
+    /**
+     * @brief returns the path of the audit file in the src folder
+     */
+    std::string auditFilePath() const;
+    /**
+     * @brief loads binary ballot files into the ballot store, approvals or
+     *        vote counts, the way setBallots does for CSV files
+     * @param type ballot type of the election
+     * @param streaming keep only the vote counts
+     * @param packed pack the ballots into approvals
+     */
+    void loadBallotFiles(BallotType type, bool streaming, bool packed);
 
 public:
     /**
@@ -50,6 +97,7 @@ public:
 
     /**
      * @brief Constructor for Election's child classes 
+     * The number of valid ballots is the sum of the ballot weights.
      */
     Election(std::vector<Ballot*> ballots, std::vector<Candidate*> candidates, int numSeats);
 
@@ -111,9 +159,101 @@ public:
     // Core functionality
     /**
      * @brief sets all ballots 
+     * The input files are either all CSV files or all binary ballot files
+     * written by csv2ballot (see ballotfile.h), which load without parsing.
+     * The ballots, candidates and invalid ballot votes belong to this
+     * Election - the next setBallots() or its destruction frees them all at
+     * once, so elections built from them must not outlive either.
      * @return all ballots as a vector of Ballot objects 
      */
     std::vector<Ballot*> setBallots();
+    /**
+     * @brief sets how many worker threads setBallots uses
+     * @param threads thread count, 0 means one per hardware thread
+     */
+    void setNumThreads(int threads);
+    /**
+     * @brief sets how many ballots tallyVotes needs before it uses threads
+     * @param ballots smallest ballot count counted in parallel
+     */
+    void setTallyThreshold(int ballots);
+    /**
+     * @brief turns streaming tally mode on or off (PV and MV only)
+     * When on, setBallots validates each row and adds it straight into
+     * per-candidate vote counts - no Ballot objects are kept.
+     * @param streaming true to count votes while loading
+     */
+    void setStreamingTally(bool streaming);
+    /**
+     * @brief turns ballot grouping on or off
+     * When on, setBallots merges ballots with identical votes into one
+     * ballot whose weight is the number of copies, so counting costs scale
+     * with distinct ballots. Every ballot ID stays available through
+     * getBallotStore().members().
+     * @param grouping true to group identical ballots
+     */
+    void setGroupBallots(bool grouping);
+    /**
+     * @brief turns packed approval ballots on or off (PV and MV only)
+     * When on, setBallots keeps each valid ballot as one bit per candidate
+     * in getApprovals() instead of building Ballot objects, and fills
+     * getVoteCounts() with a popcount tally over the packed rows.
+     * @param packed true to pack ballots into bit masks
+     */
+    void setPackedApprovals(bool packed);
+    /**
+     * @brief turns per-candidate rank columns on or off (STV only)
+     * When on, setBallots keeps a column-major copy of the ranks next to the
+     * ballot rows for contests where it pays off (RankColumns::paysOff, up to
+     * 8 candidates), for STV::setBallotStore to read first preferences from.
+     * @param columnar true to build rank columns
+     */
+    void setRankColumns(bool columnar);
+    /**
+     * @brief returns the votes per candidate counted in streaming tally mode
+     * @return vote counts indexed by candidate ID
+     */
+    const std::vector<int>& getVoteCounts() const { return voteCounts; }
+    /**
+     * @brief adds each ballot's weight to every candidate marked 1 on it (PV and MV)
+     * Reads the votes in place, so a pass over the ballots does not allocate.
+     * @param ballots ballots to count
+     * @param voteCounts per-candidate counts to add to, one entry per candidate
+     */
+    static void countVotes(const std::vector<Ballot*>& ballots, std::vector<int>& voteCounts);
+    /**
+     * @brief countVotes spread over the worker threads set by setNumThreads
+     * The ballots are cut into one shard per thread and each thread counts
+     * its shard into a private histogram on its own cache lines; the
+     * histograms are summed into voteCounts at the end. Below the tally
+     * threshold this is the serial countVotes.
+     * @param ballots ballots to count
+     * @param voteCounts per-candidate counts to add to, one entry per candidate
+     */
+    void tallyVotes(const std::vector<Ballot*>& ballots, std::vector<int>& voteCounts) const;
+    /**
+     * @brief adds each row's weight to every candidate marked 1 on it (PV and MV)
+     * Ungrouped stores are counted with the SIMD column-sum kernel picked for
+     * this CPU (see tallykernel.h).
+     * @param store ballot store to count
+     * @param voteCounts per-candidate counts to add to, one entry per candidate
+     */
+    static void countVotes(const BallotStore& store, std::vector<int>& voteCounts);
+    /**
+     * @brief returns the contiguous store behind the ballots loaded by setBallots
+     * @return ballot store, one row of votes per valid ballot
+     */
+    const BallotStore& getBallotStore() const { return ballotStore; }
+    /**
+     * @brief returns the packed ballots loaded by setBallots with packed approvals on
+     * @return approval matrix, one row of bits per valid ballot
+     */
+    const ApprovalMatrix& getApprovals() const { return approvals; }
+    /**
+     * @brief returns the ballots rejected by setBallots, in ballot ID order
+     * @return invalid ballots with the rule each one broke
+     */
+    const std::vector<InvalidBallot>& getInvalidBallots() const { return invalidBallots; }
     /**
      * @brief adds a candidate to the winner list 
      * @param candidate to be added to the list 
@@ -124,18 +264,34 @@ public:
      * @param candidate to be added to the list 
      */
     void addLoser(Candidate* candidate);
+    /**
+     * @brief records the candidates an STV count eliminated in one round
+     * Rounds that eliminated several candidates together are listed in the
+     * results and audit.
+     * @param round candidates eliminated together, lowest votes first
+     */
+    void addEliminationRound(const std::vector<Candidate*>& round);
     /**
      * @brief displays election results to the screen
      */
     void displayResults() const;
     /**
-     * @brief displays vote allocation per ballot 
+     * @brief traces the votes of every loaded ballot
+     * Written under the ballot category at debug level, nothing otherwise.
      */
     void displayBallotAllocation() const;
     /**
      * @brief prints election results to audit file 
      */
     void printToAudit() const;
+    /**
+     * @brief starts writing the audit file on a writer thread
+     * The ballot counts and removed ballots are written while the election is
+     * counted; displayResults() or printToAudit() adds the outcome and waits
+     * for the file. Call after setBallots(), which must not run again until
+     * then. Without it the whole file is written when the results are shown.
+     */
+    void beginAudit() const;
     /**
      * @brief returns plurality election results - candidates ordered from highest to lowest vote count 
      * @return results as a vector of Candidate objects
@@ -146,7 +302,11 @@ public:
      * @return results as a vector of Candidate objects
      */
     std::vector<std::vector<Candidate*>> getSTVResults() const;
-    
+
+private:
+    // Declared last so the writer thread is joined before anything it reads goes
+    mutable std::string auditPath;                   // Audit file being written
+    mutable std::unique_ptr<AsyncAuditWriter> audit; // Writer thread, from beginAudit() until the results
 };
 
 #endif // ELECTION_H
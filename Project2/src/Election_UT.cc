@@ -10,6 +10,7 @@
  */
 
 #include "Election.h"
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include <gtest/gtest.h>
@@ -103,6 +104,163 @@ TEST_F(electionUnitTests, SetBallotsWithMultipleFiles) {
   EXPECT_EQ(election.getNumBallots(), 100);
 }
 
+// Files parsed in parallel keep the IDs and order of a one-thread load
+TEST_F(electionUnitTests, SetBallotsParallelFilesTest) {
+  std::vector<std::string> files = {"../../testing/stv_all_inputs_mixed.csv",
+                                    "../../testing/stv_all_inputs_mixed_2.csv",
+                                    "../../testing/stv_all_inputs_regular.csv"};
+  Election serial(files, "stv", 3);
+  serial.setNumThreads(1);
+  serial.setBallots();
+  Election threaded(files, "stv", 3);
+  threaded.setNumThreads(4);
+  threaded.setBallots();
+
+  std::vector<Ballot *> expected = serial.getBallots();
+  std::vector<Ballot *> actual = threaded.getBallots();
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(actual[i]->getID(), expected[i]->getID());
+    EXPECT_EQ(actual[i]->getVotes(), expected[i]->getVotes());
+  }
+}
+
+// Streaming tally counts the same votes without keeping any ballots
+TEST_F(electionUnitTests, StreamingTallyTest) {
+  std::vector<std::string> files = {"../../testing/mv_mixed_ballots_100.csv"};
+  Election kept(files, "MV", 3);
+  kept.setBallots();
+  Election streamed(files, "MV", 3);
+  streamed.setStreamingTally(true);
+  streamed.setBallots();
+
+  std::vector<int> expected(kept.getCandidates().size(), 0);
+  for (Ballot *ballot : kept.getBallots()) {
+    std::vector<int> votes = ballot->getVotes();
+    for (size_t i = 0; i < votes.size(); i++)
+      expected[i] += votes[i];
+  }
+  EXPECT_TRUE(streamed.getBallots().empty());
+  EXPECT_EQ(streamed.getNumBallots(), kept.getNumBallots());
+  EXPECT_EQ(streamed.getVoteCounts(), expected);
+}
+
+// Grouped ballots count the same and keep every ballot ID
+TEST_F(electionUnitTests, GroupBallotsTest) {
+  std::vector<std::string> files = {"../../testing/stv_mixed_ballots_300.csv"};
+  Election single(files, "STV", 2);
+  single.setBallots();
+  Election grouped(files, "STV", 2);
+  grouped.setGroupBallots(true);
+  grouped.setBallots();
+
+  const BallotStore &store = grouped.getBallotStore();
+  EXPECT_TRUE(store.grouped());
+  EXPECT_LT(grouped.getBallots().size(), single.getBallots().size());
+  EXPECT_EQ(grouped.getNumBallots(), single.getNumBallots());
+
+  std::vector<int> ids;
+  int weights = 0;
+  for (size_t row = 0; row < store.size(); row++) {
+    weights += grouped.getBallots()[row]->getWeight();
+    for (int id : store.members(row))
+      ids.push_back(id);
+  }
+  std::vector<int> expected;
+  for (Ballot *ballot : single.getBallots())
+    expected.push_back(ballot->getID());
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(weights, single.getNumBallots());
+  EXPECT_EQ(ids, expected);
+
+  std::vector<int> singleCounts(single.getCandidates().size(), 0);
+  std::vector<int> groupedCounts(singleCounts.size(), 0);
+  Election::countVotes(single.getBallots(), singleCounts);
+  Election::countVotes(grouped.getBallots(), groupedCounts);
+  EXPECT_EQ(groupedCounts, singleCounts);
+}
+
+// Candidates and invalid ballot votes live in the election's arena, which a
+// second load releases and fills again
+TEST_F(electionUnitTests, ArenaTest) {
+  Election election({"../../testing/stv_mixed_ballots_300.csv"}, "STV", 2);
+  testing::internal::CaptureStderr();
+  election.setBallots();
+  std::vector<std::string> names = election.getNames();
+  std::vector<std::vector<int>> invalidVotes;
+  for (const InvalidBallot &invalid : election.getInvalidBallots())
+    invalidVotes.emplace_back(invalid.votes.begin(), invalid.votes.end());
+  ASSERT_FALSE(invalidVotes.empty());
+  EXPECT_EQ(invalidVotes[0].size(), names.size());
+
+  election.setBallots();
+  testing::internal::GetCapturedStderr();
+  EXPECT_EQ(election.getNames(), names);
+  ASSERT_EQ(election.getInvalidBallots().size(), invalidVotes.size());
+  for (size_t i = 0; i < invalidVotes.size(); i++) {
+    const InvalidBallot &invalid = election.getInvalidBallots()[i];
+    EXPECT_EQ(std::vector<int>(invalid.votes.begin(), invalid.votes.end()),
+              invalidVotes[i]);
+  }
+}
+
+// Packed approval ballots keep every valid ballot and count the same votes
+TEST_F(electionUnitTests, PackedApprovalsTest) {
+  std::vector<std::string> files = {"../../testing/mv_mixed_ballots_100.csv"};
+  Election kept(files, "MV", 3);
+  kept.setBallots();
+  Election packed(files, "MV", 3);
+  packed.setPackedApprovals(true);
+  packed.setBallots();
+
+  const ApprovalMatrix &approvals = packed.getApprovals();
+  EXPECT_TRUE(packed.getBallots().empty());
+  ASSERT_EQ(approvals.size(), kept.getBallots().size());
+  EXPECT_EQ(packed.getNumBallots(), kept.getNumBallots());
+  EXPECT_EQ(packed.getInvalidBallots().size(), kept.getInvalidBallots().size());
+  for (size_t row = 0; row < approvals.size(); row++) {
+    EXPECT_EQ(approvals.id(row), kept.getBallots()[row]->getID());
+    std::vector<int> votes = kept.getBallots()[row]->getVotes();
+    for (size_t c = 0; c < votes.size(); c++)
+      EXPECT_EQ(approvals.test(row, c), votes[c] == 1);
+  }
+
+  std::vector<int> expected(kept.getCandidates().size(), 0);
+  Election::countVotes(kept.getBallots(), expected);
+  EXPECT_EQ(packed.getVoteCounts(), expected);
+}
+
+// Sharded tallies match the serial count for any thread count
+TEST_F(electionUnitTests, TallyVotesTest) {
+  Election election({"../../testing/mv_mixed_ballots_200.csv"}, "MV", 3);
+  election.setBallots();
+  std::vector<int> expected(election.getCandidates().size(), 0);
+  Election::countVotes(election.getBallots(), expected);
+
+  election.setTallyThreshold(1);
+  for (int threads : {1, 2, 3, 8}) {
+    election.setNumThreads(threads);
+    std::vector<int> counts(expected.size(), 0);
+    election.tallyVotes(election.getBallots(), counts);
+    EXPECT_EQ(counts, expected) << threads << " threads";
+  }
+}
+
+// Counting the store directly matches counting its ballot views
+TEST_F(electionUnitTests, CountStoreTest) {
+  for (bool grouping : {false, true}) {
+    Election election({"../../testing/mv_mixed_ballots_100.csv"}, "MV", 3);
+    election.setGroupBallots(grouping);
+    election.setBallots();
+
+    std::vector<int> viewCounts(election.getCandidates().size(), 0);
+    std::vector<int> storeCounts(viewCounts.size(), 0);
+    Election::countVotes(election.getBallots(), viewCounts);
+    Election::countVotes(election.getBallotStore(), storeCounts);
+    EXPECT_EQ(storeCounts, viewCounts);
+  }
+}
+
 // Candidate handling tests
 TEST_F(electionUnitTests, GetCandidatesTest) {
   std::string testFile = "../../testing/plurality_all_inputs_2.csv";
@@ -125,6 +283,37 @@ TEST_F(electionUnitTests, GetCandidatesTest) {
   EXPECT_EQ(candidates[2]->getName(), "C");
 }
 
+// The audit file written by the writer thread holds exactly what was shown
+TEST_F(electionUnitTests, AsyncAuditTest) {
+  // Same path printToAudit builds - the src folder next to the working one
+  std::string cwd = std::filesystem::current_path().string();
+  std::string auditPath = cwd.substr(0, cwd.find_last_of("/\\")) +
+                          "\\src\\" + "async_audit_UT.txt";
+
+  Election election(
+      std::vector<std::string>{"../../testing/mv_mixed_ballots.csv"},
+      "MV", 4, "async_audit_UT.txt");
+  election.setBallots();
+  election.beginAudit();
+  for (Candidate *candidate : election.getCandidates())
+    election.addLoser(candidate);
+
+  testing::internal::CaptureStdout();
+  election.displayResults();
+  std::string output = testing::internal::GetCapturedStdout();
+
+  std::ifstream auditFile(auditPath);
+  ASSERT_TRUE(auditFile.is_open()) << auditPath;
+  std::string content((std::istreambuf_iterator<char>(auditFile)),
+                      std::istreambuf_iterator<char>());
+  auditFile.close();
+  std::remove(auditPath.c_str());
+
+  EXPECT_NE(content.find("=== List of Removed Ballots ==="), std::string::npos);
+  EXPECT_NE(content.find("Losers:"), std::string::npos);
+  EXPECT_EQ(output, content + "Audit log written to: " + auditPath + "\n");
+}
+
 // Results display tests 
 // Segfaults in Linux. Works in Windows, has a path issue in Linux for audit file.
 /*
@@ -10,13 +10,14 @@
 #include <ctime>
 #include <iostream>
 #include <random>
+#include <utility>
 #include <vector>
 
 // MV Constructor 
 // Initializes base Election class with ballots, candidates and seats
 MV::MV(std::vector<Ballot *> ballots, std::vector<Candidate *> candidates,
        int seats)
-    : Election(ballots, candidates, seats) {}
+    : Election(std::move(ballots), std::move(candidates), seats) {}
 
 // Runs the Municipal Voting election
 void MV::runElection(std::vector<Ballot *> ballots,
@@ -24,14 +25,19 @@ void MV::runElection(std::vector<Ballot *> ballots,
   // Initialize all candidate vote counts to 0 
   std::vector<int> voteCounts(candidates.size(), 0);
 
-  // Count votes from all valid ballots
-  for (auto *ballot : ballots) {
-    std::vector<int> votes = ballot->getVotes();
-    for (size_t i = 0; i < votes.size(); i++) {
-      if (votes[i] == 1) {
-        candidates[i]->updateVotes(1);
-      }
-    }
+  // Count votes from all valid ballots, sharded over threads when large
+  tallyVotes(ballots, voteCounts);
+
+  runElection(voteCounts, candidates, seats);
+}
+
+// Decides winners and losers from per-candidate vote counts
+// (also used directly by the streaming tally loader)
+void MV::runElection(const std::vector<int> &voteCounts,
+                     std::vector<Candidate *> candidates, int seats) {
+  // Add the counted votes to each candidate
+  for (size_t i = 0; i < candidates.size(); i++) {
+    candidates[i]->updateVotes(voteCounts[i]);
   }
 
   // Sort candidates by votes (descending)
@@ -30,6 +30,15 @@ public:
    */
   void runElection(std::vector<Ballot *> ballots,
                    std::vector<Candidate *> candidates, int seats);
+
+  /**
+   * @brief Runs the MV election algorithm on votes that were already counted
+   * @param voteCounts number of votes per candidate, indexed like candidates
+   * @param candidates vector of candidates up for election
+   * @param seats number of seats up for election
+   */
+  void runElection(const std::vector<int> &voteCounts,
+                   std::vector<Candidate *> candidates, int seats);
 };
 
-#endif // MV_H
\ No newline at end of file
+#endif // MV_H
\ No newline at end of file
@@ -0,0 +1,130 @@
+/*
+ * File: approvalmatrix.cpp
+ * Description: Implements the ApprovalMatrix class - bit-packed PV and MV
+ *              ballots and the bit-sliced tally over them.
+ */
+
+#include "approvalmatrix.h"
+#include <algorithm>
+
+// Constructor
+ApprovalMatrix::ApprovalMatrix(std::size_t numCandidates) {
+  reset(numCandidates);
+}
+
+// Drops rows, release the memory too
+void ApprovalMatrix::reset(std::size_t numCandidates) {
+  this->numCandidates = numCandidates;
+  wordsPerRow = (numCandidates + 63) / 64;
+  numRows = 0;
+  std::vector<std::uint64_t>().swap(masks);
+  std::vector<int>().swap(ids);
+}
+
+// Sets the number of rows
+void ApprovalMatrix::resize(std::size_t rows) {
+  numRows = rows;
+  masks.resize(rows * wordsPerRow, 0);
+  ids.resize(rows, 0);
+}
+
+// Packs one ballot, bit c of the row is candidate c
+void ApprovalMatrix::setRow(std::size_t index, const int *votes) {
+  std::uint64_t *words = masks.data() + index * wordsPerRow;
+  std::fill(words, words + wordsPerRow, 0);
+  for (std::size_t c = 0; c < numCandidates; c++)
+    if (votes[c] == 1)
+      words[c / 64] |= std::uint64_t{1} << (c % 64);
+}
+
+// Appends one ballot
+void ApprovalMatrix::addRow(const int *votes, int ballotID) {
+  resize(numRows + 1);
+  setRow(numRows - 1, votes);
+  ids[numRows - 1] = ballotID;
+}
+
+// Moves every filled range down so the rows are contiguous again
+void ApprovalMatrix::compact(const std::vector<std::size_t> &starts,
+                             const std::vector<std::size_t> &counts) {
+  std::size_t next = 0;
+  for (std::size_t i = 0; i < starts.size(); i++) {
+    if (starts[i] != next && counts[i] > 0) {
+      std::copy(masks.begin() + starts[i] * wordsPerRow,
+                masks.begin() + (starts[i] + counts[i]) * wordsPerRow,
+                masks.begin() + next * wordsPerRow);
+      std::copy(ids.begin() + starts[i], ids.begin() + starts[i] + counts[i],
+                ids.begin() + next);
+    }
+    next += counts[i];
+  }
+  resize(next);
+  masks.shrink_to_fit();
+  ids.shrink_to_fit();
+}
+
+namespace {
+
+// Carry-save adder - adds three words bit by bit, 64 columns at once
+inline void csa(std::uint64_t &high, std::uint64_t &low, std::uint64_t a,
+                std::uint64_t b, std::uint64_t c) {
+  std::uint64_t u = a ^ b;
+  high = (a & b) | (u & c);
+  low = u ^ c;
+}
+
+// Adds bit c of each word, weighted, to counts[c]
+inline void addBits(int *counts, std::uint64_t bits, int weight, int width) {
+  for (int c = 0; c < width; c++)
+    counts[c] += static_cast<int>((bits >> c) & 1) * weight;
+}
+
+} // namespace
+
+// Positional popcount (Harley-Seal): each word column keeps bit-sliced
+// running counts in ones/twos/fours/eights planes. A tree of carry-save adds
+// folds 16 ballots into them at a time, branch-free and 64 candidates per
+// operation, and only the carries out of the eights plane (worth 16 votes
+// each) are added to the int counts.
+std::vector<int> ApprovalMatrix::tally() const {
+  std::vector<int> counts(wordsPerRow * 64, 0);
+  const std::size_t fullRows = numRows - numRows % 16;
+
+  for (std::size_t w = 0; w < wordsPerRow; w++) {
+    int *out = counts.data() + w * 64;
+    const int width =
+        static_cast<int>(std::min<std::size_t>(64, numCandidates - w * 64));
+    const std::uint64_t *in = masks.data() + w;
+    auto at = [&](std::size_t r) { return in[r * wordsPerRow]; };
+    std::uint64_t ones = 0, twos = 0, fours = 0, eights = 0;
+    std::uint64_t twosA, twosB, foursA, foursB, eightsA, eightsB, sixteens;
+
+    for (std::size_t r = 0; r < fullRows; r += 16) {
+      csa(twosA, ones, ones, at(r), at(r + 1));
+      csa(twosB, ones, ones, at(r + 2), at(r + 3));
+      csa(foursA, twos, twos, twosA, twosB);
+      csa(twosA, ones, ones, at(r + 4), at(r + 5));
+      csa(twosB, ones, ones, at(r + 6), at(r + 7));
+      csa(foursB, twos, twos, twosA, twosB);
+      csa(eightsA, fours, fours, foursA, foursB);
+      csa(twosA, ones, ones, at(r + 8), at(r + 9));
+      csa(twosB, ones, ones, at(r + 10), at(r + 11));
+      csa(foursA, twos, twos, twosA, twosB);
+      csa(twosA, ones, ones, at(r + 12), at(r + 13));
+      csa(twosB, ones, ones, at(r + 14), at(r + 15));
+      csa(foursB, twos, twos, twosA, twosB);
+      csa(eightsB, fours, fours, foursA, foursB);
+      csa(sixteens, eights, eights, eightsA, eightsB);
+      addBits(out, sixteens, 16, width);
+    }
+
+    addBits(out, eights, 8, width);
+    addBits(out, fours, 4, width);
+    addBits(out, twos, 2, width);
+    addBits(out, ones, 1, width);
+    for (std::size_t r = fullRows; r < numRows; r++)
+      addBits(out, at(r), 1, width);
+  }
+  counts.resize(numCandidates);
+  return counts;
+}
@@ -0,0 +1,119 @@
+/*
+ * File: approvalmatrix.h
+ * Description: Defines the ApprovalMatrix class, which keeps PV and MV
+ *              ballots as bit masks - one bit per candidate, 64 candidates
+ *              per word - and counts them with a bit-sliced tally.
+ */
+
+#ifndef APPROVALMATRIX_H
+#define APPROVALMATRIX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class ApprovalMatrix
+ * @brief packed 0/1 ballots of a PV or MV election, one bit per candidate
+ */
+class ApprovalMatrix {
+private:
+  std::size_t numCandidates;        // Bits used per row
+  std::size_t wordsPerRow;          // 64-bit words per row
+  std::size_t numRows;              // Rows in use
+  std::vector<std::uint64_t> masks; // numRows x wordsPerRow, row-major
+  std::vector<int> ids;             // Ballot ID of each row
+
+public:
+  /**
+   * @brief Constructor for ApprovalMatrix
+   * @param numCandidates number of candidates per ballot
+   */
+  explicit ApprovalMatrix(std::size_t numCandidates = 0);
+
+  /**
+   * @brief drops every row and sets the number of candidates
+   * @param numCandidates number of candidates per ballot
+   */
+  void reset(std::size_t numCandidates);
+  /**
+   * @brief sets the number of rows, new rows have no marks
+   * Rows can then be filled in place through setRow() and setID().
+   * @param rows number of rows
+   */
+  void resize(std::size_t rows);
+  /**
+   * @brief packs the votes of one ballot into a row
+   * A candidate's bit is set when its vote is 1.
+   * @param index row index
+   * @param votes numCandidates votes
+   */
+  void setRow(std::size_t index, const int *votes);
+  /**
+   * @brief appends one ballot
+   * @param votes numCandidates votes
+   * @param ballotID ID of the ballot
+   */
+  void addRow(const int *votes, int ballotID);
+  /**
+   * @brief closes the gaps left by rows that were reserved but not filled
+   * Same contract as BallotStore::compact().
+   * @param starts first row of each range
+   * @param counts filled rows of each range
+   */
+  void compact(const std::vector<std::size_t> &starts,
+               const std::vector<std::size_t> &counts);
+
+  /**
+   * @brief returns the number of ballots
+   * @return rows in the matrix
+   */
+  std::size_t size() const { return numRows; }
+  /**
+   * @brief returns the number of candidates per ballot
+   * @return bits used per row
+   */
+  std::size_t width() const { return numCandidates; }
+  /**
+   * @brief returns the number of 64-bit words per row
+   */
+  std::size_t words() const { return wordsPerRow; }
+  /**
+   * @brief returns the packed marks of one ballot
+   * @param index row index
+   * @return pointer to words() masks, candidate c is bit c % 64 of word c / 64
+   */
+  const std::uint64_t *row(std::size_t index) const {
+    return masks.data() + index * wordsPerRow;
+  }
+  /**
+   * @brief returns true if a ballot marks a candidate
+   * @param index row index
+   * @param candidate candidate index
+   */
+  bool test(std::size_t index, std::size_t candidate) const {
+    return (row(index)[candidate / 64] >> (candidate % 64)) & 1;
+  }
+  /**
+   * @brief returns the ballot ID of a row
+   * @param index row index
+   * @return ballot ID
+   */
+  int id(std::size_t index) const { return ids[index]; }
+  /**
+   * @brief sets the ballot ID of a row
+   * @param index row index
+   * @param ballotID ballot ID
+   */
+  void setID(std::size_t index, int ballotID) { ids[index] = ballotID; }
+
+  /**
+   * @brief counts the marks of every candidate
+   * Works down each word column with carry-save adds, so one bitwise
+   * operation counts a mark for up to 64 candidates at once.
+   * @return votes per candidate, indexed by candidate ID
+   */
+  std::vector<int> tally() const;
+};
+
+#endif // APPROVALMATRIX_H
@@ -0,0 +1,79 @@
+/*
+ * File: approvalmatrix_UT.cc
+ * Description: Unit tests for the ApprovalMatrix class including:
+ *              - Packing rows into bits, also past one 64-bit word
+ *              - Compacting partly filled ranges
+ *              - Bit-sliced tallies across full and partial blocks
+ */
+
+#include "approvalmatrix.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+// Marks of 1 set a bit, anything else leaves it clear
+TEST(ApprovalMatrixTests, SetRowTest) {
+  ApprovalMatrix approvals(70);
+  std::vector<int> votes(70, 0);
+  votes[0] = 1;
+  votes[63] = 1;
+  votes[64] = 1;
+  votes[69] = 1;
+  votes[5] = 2;
+  approvals.addRow(votes.data(), 7);
+
+  ASSERT_EQ(approvals.size(), 1);
+  EXPECT_EQ(approvals.words(), 2);
+  EXPECT_EQ(approvals.id(0), 7);
+  EXPECT_EQ(approvals.row(0)[0], (1ull << 63) | 1ull);
+  EXPECT_EQ(approvals.row(0)[1], (1ull << 5) | 1ull);
+  EXPECT_TRUE(approvals.test(0, 69));
+  EXPECT_FALSE(approvals.test(0, 5));
+}
+
+// Gaps between reserved ranges are closed and row order is kept
+TEST(ApprovalMatrixTests, CompactTest) {
+  ApprovalMatrix approvals(3);
+  approvals.resize(6);
+  int first[] = {1, 0, 0};
+  int second[] = {0, 1, 0};
+  int third[] = {0, 0, 1};
+  approvals.setRow(0, first);
+  approvals.setID(0, 10);
+  approvals.setRow(3, second);
+  approvals.setID(3, 20);
+  approvals.setRow(4, third);
+  approvals.setID(4, 21);
+
+  approvals.compact({0, 3}, {1, 2});
+  ASSERT_EQ(approvals.size(), 3);
+  EXPECT_EQ(approvals.id(1), 20);
+  EXPECT_EQ(approvals.id(2), 21);
+  EXPECT_TRUE(approvals.test(1, 1));
+  EXPECT_TRUE(approvals.test(2, 2));
+}
+
+// The bit-sliced tally matches counting every mark one by one
+TEST(ApprovalMatrixTests, TallyTest) {
+  for (int numCandidates : {1, 5, 64, 65, 130}) {
+    ApprovalMatrix approvals(numCandidates);
+    std::vector<int> expected(numCandidates, 0);
+    std::mt19937 rng(numCandidates);
+    std::vector<int> votes(numCandidates);
+    for (int ballot = 0; ballot < 200; ballot++) { // 12 full blocks of 16 and 8 left
+      for (int c = 0; c < numCandidates; c++) {
+        votes[c] = rng() % 2;
+        expected[c] += votes[c];
+      }
+      approvals.addRow(votes.data(), ballot + 1);
+    }
+    EXPECT_EQ(approvals.tally(), expected) << numCandidates << " candidates";
+  }
+
+  EXPECT_EQ(ApprovalMatrix(4).tally(), (std::vector<int>{0, 0, 0, 0}));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,21 @@
+/*
+ * File: arena.cpp
+ * Description: Implements the Arena class - releasing everything an
+ *              election allocated in one go.
+ */
+
+#include "arena.h"
+
+// Constructor
+Arena::Arena(std::size_t initialBytes) : memory(initialBytes), allocated(0) {}
+
+Arena::~Arena() { release(); }
+
+// Latest object first, as their lifetimes would end on a stack
+void Arena::release() {
+  for (auto it = cleanups.rbegin(); it != cleanups.rend(); ++it)
+    it->destroy(it->object);
+  std::vector<Cleanup>().swap(cleanups);
+  memory.release();
+  allocated = 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * File: arena.h
+ * Description: Defines the Arena class, a monotonic memory pool that owns
+ *              the objects of one election. Allocating is a pointer bump and
+ *              everything is freed together when the arena is released.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Arena
+ * @brief election-scoped pool for Candidate objects and invalid ballot votes
+ * Objects are never freed one at a time. release() (or the destructor) runs
+ * the destructors of the objects made by make(), latest first, then hands
+ * all the memory back at once.
+ */
+class Arena {
+private:
+  // Destructor of one object made by make()
+  struct Cleanup {
+    void *object;
+    void (*destroy)(void *);
+  };
+
+  std::pmr::monotonic_buffer_resource memory;
+  std::vector<Cleanup> cleanups; // Objects with destructors to run
+  std::size_t allocated;         // Bytes handed out since the last release
+
+public:
+  /**
+   * @brief Constructor for Arena
+   * @param initialBytes size of the first block, later blocks grow from it
+   */
+  explicit Arena(std::size_t initialBytes = 64 * 1024);
+  ~Arena();
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /**
+   * @brief constructs an object in the arena
+   * @param args constructor arguments
+   * @return the object, valid until release() or the arena is destroyed
+   */
+  template <typename T, typename... Args> T *make(Args &&...args) {
+    void *place = allocate(sizeof(T), alignof(T));
+    T *object = ::new (place) T(std::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>)
+      cleanups.push_back(
+          {object, [](void *o) { static_cast<T *>(o)->~T(); }});
+    return object;
+  }
+
+  /**
+   * @brief copies an array of plain values into the arena
+   * @param values values to copy
+   * @return the copy, valid until release() or the arena is destroyed
+   */
+  template <typename T> std::span<const T> copy(std::span<const T> values) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "only plain values are copied without a destructor");
+    if (values.empty())
+      return {};
+    T *to = static_cast<T *>(allocate(values.size_bytes(), alignof(T)));
+    std::uninitialized_copy(values.begin(), values.end(), to);
+    return {to, values.size()};
+  }
+
+  /**
+   * @brief destroys every object and frees all the memory at once
+   */
+  void release();
+  /**
+   * @brief returns the bytes handed out since the last release
+   */
+  std::size_t bytesAllocated() const { return allocated; }
+
+private:
+  /**
+   * @brief takes bytes from the current block, adding a block when full
+   */
+  void *allocate(std::size_t bytes, std::size_t alignment) {
+    allocated += bytes;
+    return memory.allocate(bytes, alignment);
+  }
+};
+
+#endif // ARENA_H
@@ -0,0 +1,67 @@
+/*
+ * File: arena_UT.cc
+ * Description: Unit tests for the Arena class including:
+ *              - Objects made in the arena and their destructors
+ *              - Copies of plain arrays
+ *              - Releasing and reusing the arena
+ */
+
+#include "arena.h"
+#include "candidate.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Records the order destructors run in
+struct Tracked {
+  std::vector<int> *log;
+  int id;
+  Tracked(std::vector<int> *log, int id) : log(log), id(id) {}
+  ~Tracked() { log->push_back(id); }
+};
+
+} // namespace
+
+// Objects are built in place and destroyed latest first on release
+TEST(ArenaTests, MakeTest) {
+  std::vector<int> destroyed;
+  Arena arena(256);
+  Candidate *candidate = arena.make<Candidate>("A long enough candidate name", 3);
+  EXPECT_EQ(candidate->getName(), "A long enough candidate name");
+  EXPECT_EQ(candidate->getCandidateID(), 3);
+
+  arena.make<Tracked>(&destroyed, 1);
+  arena.make<Tracked>(&destroyed, 2);
+  EXPECT_GE(arena.bytesAllocated(), sizeof(Candidate) + 2 * sizeof(Tracked));
+  arena.release();
+  EXPECT_EQ(destroyed, (std::vector<int>{2, 1}));
+  EXPECT_EQ(arena.bytesAllocated(), 0u);
+
+  // The destructor releases what is left
+  {
+    Arena scoped;
+    scoped.make<Tracked>(&destroyed, 3);
+  }
+  EXPECT_EQ(destroyed, (std::vector<int>{2, 1, 3}));
+}
+
+// Copies are independent of the source and spread over several blocks
+TEST(ArenaTests, CopyTest) {
+  Arena arena(64);
+  std::vector<std::span<const int>> copies;
+  for (int i = 0; i < 100; i++) {
+    std::vector<int> values = {i, i + 1, i + 2, i + 3, i + 4};
+    copies.push_back(arena.copy(std::span<const int>(values)));
+  }
+  for (int i = 0; i < 100; i++)
+    EXPECT_EQ(std::vector<int>(copies[i].begin(), copies[i].end()),
+              (std::vector<int>{i, i + 1, i + 2, i + 3, i + 4}));
+  EXPECT_TRUE(arena.copy(std::span<const int>()).empty());
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,129 @@
+/*
+ * File: auditwriter.cpp
+ * Description: Implements the AuditWriter class.
+ */
+
+#include "auditwriter.h"
+#include <stdexcept>
+
+// Constructor - the stream writes into buffer, drained when it fills
+AuditWriter::AuditWriter(const std::string &path, std::ostream *echo)
+    : echo(echo), buffer(bufferBytes), out(this) {
+  if (!path.empty()) {
+    file = std::fopen(path.c_str(), "w");
+    // Whole buffers are written at once, stdio does not need its own
+    if (file)
+      std::setvbuf(file, nullptr, _IONBF, 0);
+  }
+  setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+AuditWriter::~AuditWriter() {
+  try {
+    close();
+  } catch (const std::runtime_error &) {
+    // Destructors do not throw - close() reports the error when called
+  }
+}
+
+void AuditWriter::close() {
+  drain();
+  if (echo)
+    echo->flush();
+  if (file) {
+    failed = std::fclose(file) != 0 || failed;
+    file = nullptr;
+    if (failed)
+      throw std::runtime_error("Failed to write audit file");
+  }
+}
+
+// Buffer full - drain it and keep the character that did not fit
+AuditWriter::int_type AuditWriter::overflow(int_type ch) {
+  drain();
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+// std::flush only drains the buffer, the file stays open
+int AuditWriter::sync() {
+  drain();
+  return failed ? -1 : 0;
+}
+
+void AuditWriter::drain() {
+  const std::size_t length = static_cast<std::size_t>(pptr() - pbase());
+  if (length > 0) {
+    if (file && std::fwrite(pbase(), 1, length, file) != length)
+      failed = true;
+    if (echo)
+      echo->write(pbase(), static_cast<std::streamsize>(length));
+  }
+  setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+// Constructor - the thread starts once every other member is ready
+AsyncAuditWriter::AsyncAuditWriter(const std::string &path)
+    : writer(path), opened(writer.isOpen()),
+      thread(&AsyncAuditWriter::run, this) {}
+
+AsyncAuditWriter::~AsyncAuditWriter() {
+  try {
+    finish();
+  } catch (...) {
+    // Destructors do not throw - finish() reports the error when called
+  }
+}
+
+void AsyncAuditWriter::queue(Section section) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    sections.push_back(std::move(section));
+  }
+  ready.notify_one();
+}
+
+void AsyncAuditWriter::finish() {
+  if (!thread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    closing = true;
+  }
+  ready.notify_one();
+  thread.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+// Sections are rendered outside the lock, so queueing never waits on the disk
+void AsyncAuditWriter::run() {
+  for (;;) {
+    Section section;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      ready.wait(lock, [this] { return closing || !sections.empty(); });
+      if (sections.empty())
+        break;
+      section = std::move(sections.front());
+      sections.pop_front();
+    }
+    // After a failure the rest is dropped, the file is incomplete anyway
+    if (error)
+      continue;
+    try {
+      section(writer.stream());
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+  try {
+    writer.close();
+  } catch (...) {
+    if (!error)
+      error = std::current_exception();
+  }
+}
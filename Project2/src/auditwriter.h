@@ -0,0 +1,140 @@
+/*
+ * File: auditwriter.h
+ * Description: Defines the AuditWriter class, an output stream that sends the
+ *              election report straight to the audit file through one fixed
+ *              buffer, optionally echoing it to the console, so the report is
+ *              rendered once and never held in memory as a whole, and
+ *              AsyncAuditWriter, which renders report sections into an
+ *              AuditWriter on a thread of its own.
+ */
+
+#ifndef AUDITWRITER_H
+#define AUDITWRITER_H
+
+#include <cstddef>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class AuditWriter
+ * @brief buffered file sink for the audit report, with an optional console copy
+ * Text written to stream() collects in a buffer of bufferBytes and goes to
+ * the file and the echo stream each time the buffer fills, so memory use does
+ * not depend on the length of the report.
+ */
+class AuditWriter : private std::streambuf {
+public:
+  static constexpr std::size_t bufferBytes = 1 << 20;
+
+  /**
+   * @brief opens the audit file, truncating it
+   * @param path audit file to write, empty to only echo
+   * @param echo stream that also receives the report, nullptr for none
+   */
+  explicit AuditWriter(const std::string &path, std::ostream *echo = nullptr);
+  /**
+   * @brief flushes and closes the file
+   */
+  ~AuditWriter() override;
+
+  AuditWriter(const AuditWriter &) = delete;
+  AuditWriter &operator=(const AuditWriter &) = delete;
+
+  /**
+   * @brief tells whether the audit file could be opened
+   */
+  bool isOpen() const { return file != nullptr; }
+  /**
+   * @brief returns the stream the report is written to
+   */
+  std::ostream &stream() { return out; }
+  /**
+   * @brief writes out what is buffered and closes the file
+   * @throws std::runtime_error if the file could not be written
+   */
+  void close();
+
+private:
+  std::FILE *file = nullptr;
+  std::ostream *echo;
+  std::vector<char> buffer;
+  bool failed = false; // a write to the file came up short
+  std::ostream out;
+
+  int_type overflow(int_type ch) override;
+  int sync() override;
+
+  /**
+   * @brief hands the buffered text to the file and the echo stream
+   */
+  void drain();
+};
+
+/**
+ * @class AsyncAuditWriter
+ * @brief audit file written by a dedicated thread
+ * Sections are queued as callbacks that render into the file's stream; the
+ * writer thread runs them in queue order, so sections known early are on
+ * disk while the caller is still counting. Anything a queued section reads
+ * must stay unchanged until finish() returns.
+ */
+class AsyncAuditWriter {
+public:
+  using Section = std::function<void(std::ostream &)>;
+
+  /**
+   * @brief opens the audit file and starts the writer thread
+   * @param path audit file to write, truncated
+   */
+  explicit AsyncAuditWriter(const std::string &path);
+  /**
+   * @brief finishes the queued sections, errors are dropped
+   */
+  ~AsyncAuditWriter();
+
+  AsyncAuditWriter(const AsyncAuditWriter &) = delete;
+  AsyncAuditWriter &operator=(const AsyncAuditWriter &) = delete;
+
+  /**
+   * @brief tells whether the audit file could be opened
+   * Sections are still rendered, and dropped, when it could not.
+   */
+  bool isOpen() const { return opened; }
+  /**
+   * @brief queues a section behind those already queued
+   * @param section callback writing the section to the stream it is given
+   */
+  void queue(Section section);
+  /**
+   * @brief waits for every queued section and closes the file
+   * @throws the first exception a section threw, or std::runtime_error if
+   *         the file could not be written
+   */
+  void finish();
+
+private:
+  AuditWriter writer;
+  bool opened;
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::deque<Section> sections; // Queued, not yet rendered
+  bool closing = false;         // No more sections will be queued
+  std::exception_ptr error;     // First failure on the writer thread
+  std::thread thread;           // Started last, once the rest is set up
+
+  /**
+   * @brief writer thread - renders sections until closing and drained
+   */
+  void run();
+};
+
+#endif // AUDITWRITER_H
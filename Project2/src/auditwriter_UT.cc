@@ -0,0 +1,109 @@
+/*
+ * File: auditwriter_UT.cc
+ * Description: Unit tests for the AuditWriter class including:
+ *              - Text reaching the file and the echo stream unchanged
+ *              - Reports longer than the buffer
+ *              - Echo-only writers and files that cannot be opened
+ *              - Sections queued to the writer thread, and their errors
+ */
+
+#include "auditwriter.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const std::string auditPath = "auditwriter_UT.txt";
+
+std::string readFile(const std::string &path) {
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+} // namespace
+
+// The file and the echo stream get the same text, formatting included
+TEST(AuditWriterTests, FileAndEchoTest) {
+  std::stringstream console;
+  AuditWriter writer(auditPath, &console);
+  ASSERT_TRUE(writer.isOpen());
+  writer.stream() << "Votes: " << 42 << " | " << std::fixed
+                  << std::setprecision(2) << 12.5 << "%\n";
+  writer.close();
+  EXPECT_FALSE(writer.isOpen());
+
+  EXPECT_EQ(console.str(), "Votes: 42 | 12.50%\n");
+  EXPECT_EQ(readFile(auditPath), console.str());
+  std::remove(auditPath.c_str());
+}
+
+// Text several buffers long arrives whole and in order
+TEST(AuditWriterTests, LongReportTest) {
+  std::string expected;
+  {
+    AuditWriter writer(auditPath);
+    for (int id = 1; expected.size() < 3 * AuditWriter::bufferBytes; id++) {
+      std::string line = "ID " + std::to_string(id) + ": 1 0 0 1 \n";
+      writer.stream() << line;
+      expected += line;
+    }
+    writer.stream() << std::flush << "end";
+    expected += "end";
+  } // closed by the destructor
+  EXPECT_EQ(readFile(auditPath), expected);
+  std::remove(auditPath.c_str());
+}
+
+// Without a file only the echo stream is written
+TEST(AuditWriterTests, EchoOnlyTest) {
+  std::stringstream console;
+  AuditWriter echoOnly("", &console);
+  EXPECT_FALSE(echoOnly.isOpen());
+  echoOnly.stream() << "results";
+  echoOnly.close();
+  EXPECT_EQ(console.str(), "results");
+
+  AuditWriter missing("no_such_dir/audit.txt", &console);
+  EXPECT_FALSE(missing.isOpen());
+  missing.stream() << " again";
+  missing.close();
+  EXPECT_EQ(console.str(), "results again");
+}
+
+// Sections are written in queue order, the last one after finish() is called
+TEST(AuditWriterTests, AsyncSectionsTest) {
+  AsyncAuditWriter writer(auditPath);
+  ASSERT_TRUE(writer.isOpen());
+  for (int i = 0; i < 100; i++)
+    writer.queue([i](std::ostream &out) { out << "section " << i << '\n'; });
+  writer.finish();
+
+  std::string expected;
+  for (int i = 0; i < 100; i++)
+    expected += "section " + std::to_string(i) + "\n";
+  EXPECT_EQ(readFile(auditPath), expected);
+  std::remove(auditPath.c_str());
+}
+
+// An exception in a section comes back from finish(), later sections are dropped
+TEST(AuditWriterTests, AsyncErrorTest) {
+  AsyncAuditWriter writer(auditPath);
+  writer.queue([](std::ostream &out) { out << "first\n"; });
+  writer.queue([](std::ostream &) { throw std::runtime_error("render"); });
+  writer.queue([](std::ostream &out) { out << "dropped\n"; });
+  EXPECT_THROW(writer.finish(), std::runtime_error);
+  EXPECT_EQ(readFile(auditPath), "first\n");
+  std::remove(auditPath.c_str());
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -7,14 +7,42 @@
 
 
 #include "ballot.h"
+#include <algorithm>
 
-// Constructor
+// Constructor - keeps its own copy of the votes
 Ballot::Ballot(std::vector<int> votes, int ballotID)
-    : votes(votes), ballotID(ballotID) {}
+    : votes(nullptr), ownedVotes(new int[votes.size()]),
+      numVotes(votes.size()), ballotID(ballotID) {
+    std::copy(votes.begin(), votes.end(), ownedVotes.get());
+    this->votes = ownedVotes.get();
+}
+
+// Constructor - views a row owned by someone else (a BallotStore)
+Ballot::Ballot(int *votes, int numVotes, int ballotID)
+    : votes(votes), numVotes(numVotes), ballotID(ballotID) {}
+
+// Copies share a viewed row but duplicate owned votes
+Ballot::Ballot(const Ballot &other)
+    : votes(other.votes), numVotes(other.numVotes), ballotID(other.ballotID),
+      weight(other.weight) {
+    if (other.ownedVotes) {
+        ownedVotes.reset(new int[numVotes]);
+        std::copy(other.votes, other.votes + numVotes, ownedVotes.get());
+        votes = ownedVotes.get();
+    }
+}
+
+Ballot &Ballot::operator=(const Ballot &other) {
+    if (this != &other) {
+        Ballot copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
 
 // Getter implementations
 std::vector<int> Ballot::getVotes() const {
-    return votes;
+    return std::vector<int>(votes, votes + numVotes);
 }
 
 // return Ballot IDs
@@ -8,17 +8,26 @@
 #ifndef BALLOT_H
 #define BALLOT_H
 
+#include <cstddef>
+#include <memory>
+#include <span>
 #include <vector>
 
 /**
  * @class Ballot
  * @brief Parent class to pluralityballot and stvballot classes.
+ * A ballot either owns a copy of its votes or views a row of a BallotStore.
  */
 
 class Ballot {
 protected:
-  std::vector<int> votes; // Vector of ranked candidate preferences
+  // Pointers first, so the ints end the object and a derived ballot's own
+  // members can start in the padding after them
+  int *votes;             // Ranked candidate preferences (ownedVotes or a BallotStore row)
+  std::unique_ptr<int[]> ownedVotes; // Only set for ballots built from a vector
+  int numVotes;           // Number of votes - one per candidate
   int ballotID;           // Unique ID for the ballot
+  int weight = 1;         // Number of identical ballots this one stands for
 
 public:
   // Constructor
@@ -26,6 +35,18 @@ public:
    * @brief Constructor for Ballot
    */
   Ballot(std::vector<int> votes, int ballotID);
+  /**
+   * @brief Constructor for a Ballot viewing votes it does not own
+   * @param votes first vote of the row, must outlive the ballot
+   * @param numVotes number of votes in the row
+   * @param ballotID unique ID for the ballot
+   */
+  Ballot(int *votes, int numVotes, int ballotID);
+
+  Ballot(const Ballot &other);
+  Ballot &operator=(const Ballot &other);
+  Ballot(Ballot &&other) = default;
+  Ballot &operator=(Ballot &&other) = default;
 
   // Getters
   /**
@@ -33,11 +54,29 @@ public:
    * @return votes as a vector of integers
    */
   std::vector<int> getVotes() const;
+  /**
+   * @brief returns a read-only view of the votes without copying them
+   * Use this on hot paths; the view is valid as long as the ballot is.
+   * @return votes as a span of integers
+   */
+  std::span<const int> getVotesView() const {
+    return {votes, static_cast<std::size_t>(numVotes)};
+  }
   /**
    * @brief returns the ID number of a specific ballot
    * @return Ballot ID as an integer
    */
   int getID() const;
+  /**
+   * @brief returns how many identical ballots this ballot stands for
+   * @return weight as an integer, 1 unless ballots were grouped
+   */
+  int getWeight() const { return weight; }
+  /**
+   * @brief sets how many identical ballots this ballot stands for
+   * @param weight number of ballots, at least 1
+   */
+  void setWeight(int weight) { this->weight = weight; }
 };
 
 #endif // BALLOT_H
@@ -0,0 +1,273 @@
+/*
+ * File: ballotfile.cpp
+ * Description: Implements the BallotFile class - writing ballot files and
+ *              reading them back out of the mapped bytes.
+ */
+
+#include "ballotfile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+static_assert(sizeof(int) == sizeof(std::int32_t),
+              "ballot files store votes and IDs as 32-bit ints");
+
+namespace {
+
+// Sections start on 8-byte boundaries so int32 and uint64 reads are aligned
+std::uint64_t aligned(std::uint64_t offset) { return (offset + 7) & ~7ull; }
+
+// Output file that keeps count of the bytes written, for the padding
+class Writer {
+public:
+  explicit Writer(const std::string &fileName)
+      : out(fileName, std::ios::binary | std::ios::trunc) {}
+  bool isOpen() const { return out.is_open(); }
+  bool good() const { return out.good(); }
+  std::uint64_t offset() const { return written; }
+
+  void bytes(const void *data, std::size_t length) {
+    out.write(static_cast<const char *>(data),
+              static_cast<std::streamsize>(length));
+    written += length;
+  }
+  template <typename T> void value(T v) { bytes(&v, sizeof(v)); }
+  void pad() {
+    static const char zeros[8] = {};
+    bytes(zeros, aligned(written) - written);
+  }
+
+private:
+  std::ofstream out;
+  std::uint64_t written = 0;
+};
+
+// Widest unsigned vote size that holds every valid vote, 4 for int32
+std::uint32_t voteBytesFor(const std::vector<Ballot *> &ballots) {
+  int low = 0, high = 0;
+  for (const Ballot *ballot : ballots) {
+    for (int v : ballot->getVotesView()) {
+      low = std::min(low, v);
+      high = std::max(high, v);
+    }
+  }
+  if (low < 0 || high > std::numeric_limits<std::uint16_t>::max())
+    return 4;
+  return high > std::numeric_limits<std::uint8_t>::max() ? 2 : 1;
+}
+
+template <typename T>
+void widen(const char *from, std::size_t count, int *to) {
+  for (std::size_t i = 0; i < count; i++) {
+    T v;
+    std::memcpy(&v, from + i * sizeof(T), sizeof(T));
+    to[i] = static_cast<int>(v);
+  }
+}
+
+} // namespace
+
+// Maps the file and checks everything the readers rely on up front
+BallotFile::BallotFile(const std::string &fileName)
+    : file(fileName), fileName(fileName) {
+  std::string_view bytes = file.view();
+  const std::string invalid = "Invalid ballot file: " + fileName;
+  if (bytes.size() < sizeof(Header))
+    throw std::runtime_error(invalid);
+  std::memcpy(&header, bytes.data(), sizeof(Header));
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+      header.byteOrder != byteOrder)
+    throw std::runtime_error(invalid);
+  if (header.version != version)
+    throw std::runtime_error("Unsupported ballot file version " +
+                             std::to_string(header.version) + ": " + fileName);
+  if (header.voteBytes != 1 && header.voteBytes != 2 && header.voteBytes != 4)
+    throw std::runtime_error(invalid);
+  if (header.footerOffset < sizeof(Header) ||
+      header.footerOffset > bytes.size() ||
+      bytes.size() - header.footerOffset != sizeof(Footer))
+    throw std::runtime_error(invalid);
+  std::memcpy(&footer, bytes.data() + header.footerOffset, sizeof(Footer));
+  if (std::memcmp(footer.endMagic, endMagic, sizeof(endMagic)) != 0)
+    throw std::runtime_error(invalid);
+
+  // Every section has to fit before the footer - the sizes come from the
+  // header, so a product that wraps around is rejected before the check
+  auto size = [&](std::uint64_t count, std::uint64_t each) {
+    std::uint64_t bytes;
+    if (__builtin_mul_overflow(count, each, &bytes))
+      throw std::runtime_error(invalid);
+    return bytes;
+  };
+  const std::uint64_t rows = header.numValid, bad = header.numInvalid;
+  const std::uint64_t width = header.numCandidates;
+  section(footer.votes, size(size(rows, width), header.voteBytes));
+  section(footer.ids, size(rows, sizeof(std::int32_t)));
+  section(footer.invalidIDs, size(bad, sizeof(std::int32_t)));
+  section(footer.invalidReasons, bad);
+  section(footer.invalidVotes, size(size(bad, width), sizeof(std::int32_t)));
+  if (footer.invalidVotes % alignof(std::int32_t) != 0)
+    throw std::runtime_error(invalid);
+
+  // Each invalid ballot is reported by its reason - anything but a rule an
+  // invalid ballot can break would leave its audit message empty
+  const char *reasons = section(footer.invalidReasons, bad);
+  for (std::uint64_t i = 0; i < bad; i++) {
+    const unsigned reason = static_cast<unsigned char>(reasons[i]);
+    if (reason <= static_cast<unsigned>(BallotStatus::Valid) ||
+        reason > static_cast<unsigned>(BallotStatus::NotZeroOrOne))
+      throw std::runtime_error(invalid);
+  }
+
+  // Names - the algorithm first, then one per candidate
+  std::uint64_t at = footer.names;
+  auto readString = [&]() {
+    std::uint32_t length;
+    std::memcpy(&length, section(at, sizeof(length)), sizeof(length));
+    const char *text = section(at + sizeof(length), length);
+    at += sizeof(length) + length;
+    return std::string(text, length);
+  };
+  algorithmName = readString();
+  candidateNames.reserve(header.numCandidates);
+  for (std::uint32_t c = 0; c < header.numCandidates; c++)
+    candidateNames.push_back(readString());
+}
+
+bool BallotFile::detect(const std::string &fileName) {
+  std::ifstream in(fileName, std::ios::binary);
+  char start[sizeof(magic)] = {};
+  in.read(start, sizeof(start));
+  return in.gcount() == sizeof(start) &&
+         std::memcmp(start, magic, sizeof(magic)) == 0;
+}
+
+// Section offsets only depend on the counts, so the header and footer are
+// known before anything is written
+void BallotFile::write(const std::string &fileName, const std::string &algorithm,
+                       int numSeats, const std::vector<std::string> &names,
+                       const std::vector<Ballot *> &ballots,
+                       const std::vector<InvalidBallot> &invalidBallots) {
+  for (const Ballot *ballot : ballots)
+    if (ballot->getWeight() != 1)
+      throw std::invalid_argument("Grouped ballots cannot be written to " +
+                                  fileName);
+
+  Header head = {};
+  std::memcpy(head.magic, magic, sizeof(magic));
+  head.version = version;
+  head.byteOrder = byteOrder;
+  head.voteBytes = voteBytesFor(ballots);
+  head.numSeats = static_cast<std::uint32_t>(numSeats);
+  head.numCandidates = static_cast<std::uint32_t>(names.size());
+  head.numValid = ballots.size();
+  head.numInvalid = invalidBallots.size();
+
+  Footer foot = {};
+  std::memcpy(foot.endMagic, endMagic, sizeof(endMagic));
+  std::uint64_t namesLength = sizeof(std::uint32_t) + algorithm.size();
+  for (const std::string &name : names)
+    namesLength += sizeof(std::uint32_t) + name.size();
+  const std::uint64_t width = names.size();
+  foot.names = sizeof(Header);
+  foot.votes = aligned(foot.names + namesLength);
+  foot.ids = aligned(foot.votes + head.numValid * width * head.voteBytes);
+  foot.invalidIDs = aligned(foot.ids + head.numValid * sizeof(std::int32_t));
+  foot.invalidReasons = foot.invalidIDs + head.numInvalid * sizeof(std::int32_t);
+  foot.invalidVotes = aligned(foot.invalidReasons + head.numInvalid);
+  head.footerOffset = aligned(foot.invalidVotes +
+                              head.numInvalid * width * sizeof(std::int32_t));
+
+  Writer out(fileName);
+  if (!out.isOpen())
+    throw std::runtime_error("Failed to create ballot file: " + fileName);
+  out.value(head);
+
+  auto writeString = [&](const std::string &text) {
+    out.value(static_cast<std::uint32_t>(text.size()));
+    out.bytes(text.data(), text.size());
+  };
+  writeString(algorithm);
+  for (const std::string &name : names)
+    writeString(name);
+
+  out.pad();
+  for (const Ballot *ballot : ballots) {
+    for (int v : ballot->getVotesView()) {
+      if (head.voteBytes == 1)
+        out.value(static_cast<std::uint8_t>(v));
+      else if (head.voteBytes == 2)
+        out.value(static_cast<std::uint16_t>(v));
+      else
+        out.value(static_cast<std::int32_t>(v));
+    }
+  }
+
+  out.pad();
+  for (const Ballot *ballot : ballots)
+    out.value(static_cast<std::int32_t>(ballot->getID()));
+
+  out.pad();
+  for (const InvalidBallot &invalid : invalidBallots)
+    out.value(static_cast<std::int32_t>(invalid.ballotID));
+  for (const InvalidBallot &invalid : invalidBallots)
+    out.value(static_cast<std::uint8_t>(invalid.reason));
+  out.pad();
+  for (const InvalidBallot &invalid : invalidBallots) {
+    // Rows are always numCandidates wide, as parsed
+    for (std::size_t c = 0; c < width; c++)
+      out.value(static_cast<std::int32_t>(
+          c < invalid.votes.size() ? invalid.votes[c] : 0));
+  }
+
+  out.pad();
+  if (out.offset() != head.footerOffset)
+    throw std::logic_error("Ballot file layout mismatch: " + fileName);
+  out.value(foot);
+  if (!out.good())
+    throw std::runtime_error("Failed to write ballot file: " + fileName);
+}
+
+void BallotFile::readVotes(std::size_t first, std::size_t count,
+                           int *votes) const {
+  const std::size_t width = header.numCandidates;
+  const char *from =
+      file.view().data() + footer.votes + first * width * header.voteBytes;
+  if (header.voteBytes == 1)
+    widen<std::uint8_t>(from, count * width, votes);
+  else if (header.voteBytes == 2)
+    widen<std::uint16_t>(from, count * width, votes);
+  else
+    std::memcpy(votes, from, count * width * sizeof(int));
+}
+
+void BallotFile::readIDs(std::size_t first, std::size_t count, int *ids) const {
+  std::memcpy(ids, file.view().data() + footer.ids + first * sizeof(std::int32_t),
+              count * sizeof(std::int32_t));
+}
+
+InvalidBallot BallotFile::invalidBallot(std::size_t index) const {
+  const char *bytes = file.view().data();
+  const std::size_t width = header.numCandidates;
+  InvalidBallot invalid;
+  std::int32_t id;
+  std::memcpy(&id, bytes + footer.invalidIDs + index * sizeof(id), sizeof(id));
+  invalid.ballotID = id;
+  // Reasons were range-checked when the file was opened
+  invalid.reason = static_cast<BallotStatus>(
+      static_cast<unsigned char>(bytes[footer.invalidReasons + index]));
+  // The section is int-aligned (checked when the file was opened)
+  invalid.votes = {reinterpret_cast<const int *>(
+                       bytes + footer.invalidVotes + index * width * sizeof(int)),
+                   width};
+  return invalid;
+}
+
+const char *BallotFile::section(std::uint64_t offset,
+                                std::uint64_t length) const {
+  if (offset > header.footerOffset || length > header.footerOffset - offset)
+    throw std::runtime_error("Invalid ballot file: " + fileName);
+  return file.view().data() + offset;
+}
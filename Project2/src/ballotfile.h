@@ -0,0 +1,147 @@
+/*
+ * File: ballotfile.h
+ * Description: Defines the BallotFile class, a versioned binary container for
+ *              ballots that were already parsed and validated from CSV files.
+ *              The file is memory-mapped and its rows are copied straight out
+ *              of the mapping, so loading it involves no text parsing at all.
+ */
+
+#ifndef BALLOTFILE_H
+#define BALLOTFILE_H
+
+#include "ballot.h"
+#include "ballotstatus.h"
+#include "csvparser.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class BallotFile
+ * @brief read-only view of a binary ballot file
+ *
+ * Layout, version 1, little-endian, every section starting 8-byte aligned:
+ *   header   Header below
+ *   names    algorithm, then each candidate name, as uint32 length + bytes
+ *   votes    numValid rows of numCandidates votes, voteBytes each
+ *   ids      numValid int32 ballot IDs
+ *   invalid  numInvalid int32 IDs, numInvalid uint8 reasons (BallotStatus),
+ *            then numInvalid rows of numCandidates int32 votes
+ *   footer   Footer below - the offset of every section
+ * Votes are unsigned bytes or shorts when every valid vote fits, int32
+ * otherwise.
+ */
+class BallotFile {
+public:
+  static constexpr char magic[8] = {'V', 'S', 'B', 'A', 'L', 'L', 'O', 'T'};
+  static constexpr char endMagic[8] = {'V', 'S', 'B', 'A', 'L', 'E', 'N', 'D'};
+  static constexpr std::uint32_t version = 1;
+  static constexpr std::uint32_t byteOrder = 0x01020304;
+
+  /**
+   * @brief fixed header at the start of the file
+   */
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;    // Written as byteOrder, read back swapped on the wrong host
+    std::uint32_t voteBytes;    // 1, 2 or 4
+    std::uint32_t numSeats;
+    std::uint32_t numCandidates;
+    std::uint32_t reserved;
+    std::uint64_t numValid;     // Valid ballot rows
+    std::uint64_t numInvalid;   // Invalid ballots kept for the audit
+    std::uint64_t footerOffset; // Where the Footer starts
+  };
+
+  /**
+   * @brief index at the end of the file - byte offset of each section
+   */
+  struct Footer {
+    std::uint64_t names;
+    std::uint64_t votes;
+    std::uint64_t ids;
+    std::uint64_t invalidIDs;
+    std::uint64_t invalidReasons;
+    std::uint64_t invalidVotes;
+    char endMagic[8];
+  };
+
+  /**
+   * @brief maps a ballot file and checks its header and index
+   * @param fileName path of the file
+   * @throws std::runtime_error if the file cannot be read, is not a
+   *         version 1 ballot file or records an unknown invalid reason
+   */
+  explicit BallotFile(const std::string &fileName);
+
+  /**
+   * @brief tells whether a file starts with the ballot file magic
+   * @param fileName path of the file
+   * @return false for CSV files and files that cannot be opened
+   */
+  static bool detect(const std::string &fileName);
+
+  /**
+   * @brief writes ballots to a ballot file
+   * @param fileName path of the file, truncated
+   * @param algorithm algorithm name from the CSV header
+   * @param numSeats number of seats
+   * @param names candidate names
+   * @param ballots valid ballots, not grouped, in ID order
+   * @param invalidBallots invalid ballots kept for the audit
+   * @throws std::runtime_error if the file cannot be written
+   * @throws std::invalid_argument if a ballot stands for several ballots
+   */
+  static void write(const std::string &fileName, const std::string &algorithm,
+                    int numSeats, const std::vector<std::string> &names,
+                    const std::vector<Ballot *> &ballots,
+                    const std::vector<InvalidBallot> &invalidBallots);
+
+  // Getters
+  const std::string &algorithm() const { return algorithmName; }
+  int seats() const { return static_cast<int>(header.numSeats); }
+  const std::vector<std::string> &names() const { return candidateNames; }
+  std::size_t numCandidates() const { return header.numCandidates; }
+  std::size_t numValid() const { return header.numValid; }
+  std::size_t numInvalid() const { return header.numInvalid; }
+  int voteBytes() const { return static_cast<int>(header.voteBytes); }
+
+  /**
+   * @brief copies valid rows out of the mapping, widened to ints
+   * @param first first row
+   * @param count number of rows
+   * @param votes receives count x numCandidates() votes
+   */
+  void readVotes(std::size_t first, std::size_t count, int *votes) const;
+  /**
+   * @brief copies the IDs of valid rows
+   * @param first first row
+   * @param count number of rows
+   * @param ids receives count IDs
+   */
+  void readIDs(std::size_t first, std::size_t count, int *ids) const;
+  /**
+   * @brief returns one invalid ballot
+   * Its votes point into the mapping and are only valid while this
+   * BallotFile is.
+   * @param index index among the invalid ballots
+   */
+  InvalidBallot invalidBallot(std::size_t index) const;
+
+private:
+  MappedFile file;
+  std::string fileName;
+  Header header;
+  Footer footer;
+  std::string algorithmName;
+  std::vector<std::string> candidateNames;
+
+  /**
+   * @brief returns the bytes at an offset, checking they lie before the footer
+   */
+  const char *section(std::uint64_t offset, std::uint64_t length) const;
+};
+
+#endif // BALLOTFILE_H
@@ -0,0 +1,205 @@
+/*
+ * File: ballotfile_UT.cc
+ * Description: Unit tests for the BallotFile class including:
+ *              - CSV ballots written and loaded back unchanged, over several files
+ *              - Streaming and packed PV/MV loads from a ballot file
+ *              - Vote widths and rejecting damaged or mixed input
+ *              - Rejecting rows and invalid reasons changed after writing
+ */
+
+#include "Election.h"
+#include "ballotfile.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Converts CSV files the way csv2ballot does
+void convert(const std::vector<std::string> &csvFiles,
+             const std::string &algorithm, int seats,
+             const std::string &output) {
+  Election election(csvFiles, algorithm, seats);
+  election.setBallots();
+  BallotFile::write(output, algorithm, seats, election.getNames(),
+                    election.getBallots(), election.getInvalidBallots());
+}
+
+// Copies a ballot file with one byte changed, offset taken from its footer
+void patch(const std::string &from, const std::string &to,
+           std::uint64_t BallotFile::Footer::*section, char value) {
+  std::ifstream in(from, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(in)),
+                    std::istreambuf_iterator<char>());
+  BallotFile::Footer footer;
+  std::memcpy(&footer, bytes.data() + bytes.size() - sizeof(footer),
+              sizeof(footer));
+  bytes[footer.*section] = value;
+  std::ofstream out(to, std::ios::binary);
+  out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+} // namespace
+
+// Every ballot, ID and invalid ballot comes back as the CSV files gave them
+TEST(BallotFileTests, RoundTripTest) {
+  std::vector<std::string> csvFiles = {"../../testing/stv_mixed_ballots_300.csv",
+                                       "../../testing/stv_mixed_ballots_300.csv"};
+  convert(csvFiles, "STV", 2, "roundtrip_UT.ballot");
+
+  BallotFile file("roundtrip_UT.ballot");
+  EXPECT_EQ(file.algorithm(), "STV");
+  EXPECT_EQ(file.seats(), 2);
+  EXPECT_EQ(file.voteBytes(), 1);
+
+  Election csv(csvFiles, "STV", 2);
+  csv.setBallots();
+  Election binary({"roundtrip_UT.ballot"}, "STV", 2);
+  binary.setBallots();
+
+  EXPECT_EQ(binary.getNames(), csv.getNames());
+  EXPECT_EQ(binary.getNumBallots(), csv.getNumBallots());
+  ASSERT_EQ(binary.getBallots().size(), csv.getBallots().size());
+  for (size_t i = 0; i < csv.getBallots().size(); i++) {
+    EXPECT_EQ(binary.getBallots()[i]->getID(), csv.getBallots()[i]->getID());
+    EXPECT_EQ(binary.getBallots()[i]->getVotes(),
+              csv.getBallots()[i]->getVotes());
+  }
+  ASSERT_EQ(binary.getInvalidBallots().size(), csv.getInvalidBallots().size());
+  EXPECT_FALSE(csv.getInvalidBallots().empty());
+  for (size_t i = 0; i < csv.getInvalidBallots().size(); i++) {
+    const InvalidBallot &expected = csv.getInvalidBallots()[i];
+    const InvalidBallot &actual = binary.getInvalidBallots()[i];
+    EXPECT_EQ(actual.ballotID, expected.ballotID);
+    EXPECT_EQ(std::vector<int>(actual.votes.begin(), actual.votes.end()),
+              std::vector<int>(expected.votes.begin(), expected.votes.end()));
+    EXPECT_EQ(actual.reason, expected.reason);
+  }
+
+  // A second copy of the file continues the IDs, like a second CSV file
+  Election twice({"roundtrip_UT.ballot", "roundtrip_UT.ballot"}, "STV", 2);
+  twice.setBallots();
+  ASSERT_EQ(twice.getBallots().size(), 2 * csv.getBallots().size());
+  EXPECT_EQ(twice.getBallots()[csv.getBallots().size()]->getID(),
+            csv.getBallots().front()->getID() + 600);
+  std::remove("roundtrip_UT.ballot");
+}
+
+// Vote counts match the CSV load whether ballots are streamed or packed
+TEST(BallotFileTests, StreamingAndPackedTest) {
+  std::vector<std::string> csvFiles = {"../../testing/mv_mixed_ballots_100.csv"};
+  convert(csvFiles, "MV", 3, "mv_UT.ballot");
+
+  Election csv(csvFiles, "MV", 3);
+  csv.setStreamingTally(true);
+  csv.setBallots();
+  Election streamed({"mv_UT.ballot"}, "MV", 3);
+  streamed.setStreamingTally(true);
+  streamed.setBallots();
+  Election packed({"mv_UT.ballot"}, "MV", 3);
+  packed.setPackedApprovals(true);
+  packed.setBallots();
+
+  EXPECT_TRUE(streamed.getBallots().empty());
+  EXPECT_EQ(streamed.getVoteCounts(), csv.getVoteCounts());
+  EXPECT_EQ(packed.getVoteCounts(), csv.getVoteCounts());
+  EXPECT_EQ(streamed.getNumBallots(), csv.getNumBallots());
+
+  // Rows were validated as MV ballots, an STV count cannot use them
+  Election wrongType({"mv_UT.ballot"}, "STV", 3);
+  EXPECT_THROW(wrongType.setBallots(), std::runtime_error);
+  std::remove("mv_UT.ballot");
+}
+
+// Votes are stored as narrow as they fit; damaged or mixed input is refused
+TEST(BallotFileTests, WidthAndErrorTest) {
+  Ballot wide({300, 1}, 1);
+  std::vector<Ballot *> ballots = {&wide};
+  BallotFile::write("wide_UT.ballot", "STV", 1, {"A", "B"}, ballots, {});
+  BallotFile file("wide_UT.ballot");
+  EXPECT_EQ(file.voteBytes(), 2);
+  std::vector<int> votes(2);
+  file.readVotes(0, 1, votes.data());
+  EXPECT_EQ(votes, (std::vector<int>{300, 1}));
+  EXPECT_TRUE(BallotFile::detect("wide_UT.ballot"));
+  EXPECT_FALSE(BallotFile::detect("../../testing/stv_ballots.csv"));
+
+  Election mixed({"wide_UT.ballot", "../../testing/stv_ballots.csv"}, "STV", 1);
+  EXPECT_THROW(mixed.setBallots(), std::runtime_error);
+
+  // Cut short - the footer is gone
+  {
+    std::ifstream in("wide_UT.ballot", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+    std::ofstream out("cut_UT.ballot", std::ios::binary);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 8));
+  }
+  EXPECT_THROW(BallotFile("cut_UT.ballot"), std::runtime_error);
+  std::remove("cut_UT.ballot");
+
+  // Row count whose section sizes wrap around to 0 bytes
+  {
+    std::ifstream in("wide_UT.ballot", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+    BallotFile::Header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.numValid = std::uint64_t{1} << 62;
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::ofstream out("wrap_UT.ballot", std::ios::binary);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  }
+  EXPECT_THROW(BallotFile("wrap_UT.ballot"), std::runtime_error);
+  std::remove("wrap_UT.ballot");
+  std::remove("wide_UT.ballot");
+}
+
+// A valid row or an invalid reason changed after writing rejects the file
+TEST(BallotFileTests, TamperedFileTest) {
+  Ballot valid({1, 0}, 1);
+  std::vector<Ballot *> ballots = {&valid};
+  const std::vector<int> twoVotes = {1, 1};
+  std::vector<InvalidBallot> invalid = {
+      {2, twoVotes, BallotStatus::NotZeroOrOne}};
+  BallotFile::write("good_UT.ballot", "MV", 1, {"A", "B"}, ballots, invalid);
+
+  // First vote of the valid row becomes 2
+  patch("good_UT.ballot", "row_UT.ballot", &BallotFile::Footer::votes, 2);
+  EXPECT_NO_THROW(BallotFile("row_UT.ballot"));
+  Election stored({"row_UT.ballot"}, "MV", 1);
+  EXPECT_THROW(stored.setBallots(), std::runtime_error);
+  Election streamed({"row_UT.ballot"}, "MV", 1);
+  streamed.setStreamingTally(true);
+  EXPECT_THROW(streamed.setBallots(), std::runtime_error);
+  Election packed({"row_UT.ballot"}, "MV", 1);
+  packed.setPackedApprovals(true);
+  EXPECT_THROW(packed.setBallots(), std::runtime_error);
+
+  // Reasons outside the rules an invalid ballot can break
+  patch("good_UT.ballot", "reason_UT.ballot",
+        &BallotFile::Footer::invalidReasons, 0);
+  EXPECT_THROW(BallotFile("reason_UT.ballot"), std::runtime_error);
+  patch("good_UT.ballot", "reason_UT.ballot",
+        &BallotFile::Footer::invalidReasons, 9);
+  EXPECT_THROW(BallotFile("reason_UT.ballot"), std::runtime_error);
+
+  Election good({"good_UT.ballot"}, "MV", 1);
+  good.setBallots();
+  EXPECT_EQ(good.getBallots().size(), 1u);
+  ASSERT_EQ(good.getInvalidBallots().size(), 1u);
+  EXPECT_EQ(good.getInvalidBallots()[0].reason, BallotStatus::NotZeroOrOne);
+  std::remove("row_UT.ballot");
+  std::remove("reason_UT.ballot");
+  std::remove("good_UT.ballot");
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
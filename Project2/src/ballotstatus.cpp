@@ -0,0 +1,107 @@
+/*
+ * File: ballotstatus.cpp
+ * Description: Implements the exception-free ballot validation and the
+ *              error messages of invalid ballots.
+ */
+
+#include "ballotstatus.h"
+
+// Resolves the ballot type once instead of comparing strings on every row
+BallotType ballotTypeFor(const std::string &algorithm) {
+  // Meek STV counts the same ranked ballots as STV
+  if (algorithm == "STV" || algorithm == "stv" || algorithm == "MEEK" ||
+      algorithm == "meek")
+    return BallotType::STV;
+  if (algorithm == "PV" || algorithm == "pv")
+    return BallotType::PV;
+  if (algorithm == "MV" || algorithm == "mv")
+    return BallotType::MV;
+  return BallotType::None;
+}
+
+// Number of candidates with a rank
+static int countRanked(const int *votes, int numVotes) {
+  int rankedCount = 0;
+  for (int i = 0; i < numVotes; i++) {
+    if (votes[i] > 0)
+      rankedCount++;
+  }
+  return rankedCount;
+}
+
+// Require at least half (floor division) of candidates to be ranked
+BallotStatus validateSTV(const int *votes, int numVotes) {
+  return countRanked(votes, numVotes) < numVotes / 2 ? BallotStatus::TooFewRanked
+                                                     : BallotStatus::Valid;
+}
+
+// A valid Plurality ballot has exactly one '1' and only 0's otherwise
+BallotStatus validatePlurality(const int *votes, int numVotes) {
+  int voteCount = 0;
+  for (int i = 0; i < numVotes; i++) {
+    if (votes[i] == 1)
+      voteCount++;
+    else if (votes[i] != 0)
+      return BallotStatus::NonBinaryVote;
+  }
+  return voteCount == 1 ? BallotStatus::Valid : BallotStatus::NotExactlyOne;
+}
+
+// Each vote is either 0 (no) or 1 (yes)
+BallotStatus validateMV(const int *votes, int numVotes) {
+  for (int i = 0; i < numVotes; i++) {
+    if (votes[i] != 0 && votes[i] != 1)
+      return BallotStatus::NotZeroOrOne;
+  }
+  return BallotStatus::Valid;
+}
+
+BallotStatus validateBallot(BallotType type, const int *votes, int numVotes) {
+  switch (type) {
+  case BallotType::STV:
+    return validateSTV(votes, numVotes);
+  case BallotType::PV:
+    return validatePlurality(votes, numVotes);
+  case BallotType::MV:
+    return validateMV(votes, numVotes);
+  default:
+    return BallotStatus::Valid;
+  }
+}
+
+const char *ballotStatusReason(BallotStatus status) {
+  switch (status) {
+  case BallotStatus::Valid:
+    return "valid";
+  case BallotStatus::TooFewRanked:
+    return "too few candidates ranked";
+  case BallotStatus::NonBinaryVote:
+    return "non-zero/non-one value";
+  case BallotStatus::NotExactlyOne:
+    return "not exactly one 1";
+  case BallotStatus::NotZeroOrOne:
+    return "value other than 0 or 1";
+  }
+  return "unknown";
+}
+
+// Same text the ballot constructors have always thrown
+std::string ballotStatusMessage(BallotStatus status, int ballotID,
+                                const int *votes, int numVotes) {
+  const std::string id = std::to_string(ballotID);
+  switch (status) {
+  case BallotStatus::TooFewRanked:
+    return "\nInvalid STV Ballot " + id + ": Only " +
+           std::to_string(countRanked(votes, numVotes)) +
+           " candidates ranked (minimum " + std::to_string(numVotes / 2) +
+           " required).";
+  case BallotStatus::NonBinaryVote:
+    return "\nInvalid Plurality ballot " + id + ": Non-zero/non-one value found.";
+  case BallotStatus::NotExactlyOne:
+    return "\nInvalid Plurality ballot " + id + ": Exactly one '1' is required.";
+  case BallotStatus::NotZeroOrOne:
+    return "\nInvalid MV ballot " + id + ": Must have only 1's or 0's.";
+  default:
+    return "";
+  }
+}
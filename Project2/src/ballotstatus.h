@@ -0,0 +1,96 @@
+/*
+ * File: ballotstatus.h
+ * Description: Validation of ballot rows without exceptions. Each rule of
+ *              the STV, Plurality and MV ballots is reported as a status code,
+ *              which the loaders check before building any ballot, and which
+ *              turns back into the usual error message for the audit.
+ */
+
+#ifndef BALLOTSTATUS_H
+#define BALLOTSTATUS_H
+
+#include <span>
+#include <string>
+
+/**
+ * @brief ballot type built for each election algorithm
+ */
+enum class BallotType { None, STV, PV, MV };
+
+/**
+ * @brief resolves the ballot type of an algorithm name ("STV", "pv", ...)
+ * @param algorithm algorithm name as read from the csv header
+ * @return matching ballot type, None if unknown
+ */
+BallotType ballotTypeFor(const std::string &algorithm);
+
+/**
+ * @brief result of validating a ballot row
+ */
+enum class BallotStatus {
+  Valid,
+  TooFewRanked,   // STV: fewer than half of the candidates ranked
+  NonBinaryVote,  // Plurality: a value other than 0 or 1
+  NotExactlyOne,  // Plurality: zero or several 1's
+  NotZeroOrOne    // MV: a value other than 0 or 1
+};
+
+/**
+ * @brief an invalid ballot kept for the results and the audit
+ * The votes are not owned - Election keeps them in its arena, and a
+ * BallotFile's point into the mapped file.
+ */
+struct InvalidBallot {
+  int ballotID;                // ID the ballot would have had
+  std::span<const int> votes;  // Votes as parsed
+  BallotStatus reason;         // Rule the ballot broke
+};
+
+/**
+ * @brief checks the STV minimum ranking rule
+ * @param votes first vote of the row
+ * @param numVotes number of votes in the row
+ * @return Valid or TooFewRanked
+ */
+BallotStatus validateSTV(const int *votes, int numVotes);
+/**
+ * @brief checks the plurality rules - exactly one 1, every other vote 0
+ * @param votes first vote of the row
+ * @param numVotes number of votes in the row
+ * @return Valid, NonBinaryVote or NotExactlyOne
+ */
+BallotStatus validatePlurality(const int *votes, int numVotes);
+/**
+ * @brief checks the MV rule - every vote 0 or 1
+ * @param votes first vote of the row
+ * @param numVotes number of votes in the row
+ * @return Valid or NotZeroOrOne
+ */
+BallotStatus validateMV(const int *votes, int numVotes);
+/**
+ * @brief checks a row against the rules of a ballot type
+ * @param type ballot type, None accepts every row
+ * @param votes first vote of the row
+ * @param numVotes number of votes in the row
+ * @return validation status
+ */
+BallotStatus validateBallot(BallotType type, const int *votes, int numVotes);
+
+/**
+ * @brief returns a short description of a status, e.g. for logs
+ * @param status validation status
+ * @return reason text
+ */
+const char *ballotStatusReason(BallotStatus status);
+/**
+ * @brief builds the error message the ballot constructors report
+ * @param status validation status, not Valid
+ * @param ballotID ID of the ballot
+ * @param votes first vote of the row
+ * @param numVotes number of votes in the row
+ * @return message, starting with a newline like the constructor exceptions
+ */
+std::string ballotStatusMessage(BallotStatus status, int ballotID,
+                                const int *votes, int numVotes);
+
+#endif // BALLOTSTATUS_H
@@ -0,0 +1,87 @@
+/*
+ * File: ballotstatus_UT.cc
+ * Description: Unit tests for the exception-free ballot validation including:
+ *              - Status codes of each ballot type's rules
+ *              - Error messages matching the ballot constructors
+ *              - Invalid ballots collected with their reason by setBallots
+ */
+
+#include "Election.h"
+#include "ballotstatus.h"
+#include "mvballot.h"
+#include "pluralityballot.h"
+#include "stvballot.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Message thrown by a ballot constructor, empty if it did not throw
+template <typename BallotClass> std::string thrownMessage(std::vector<int> votes) {
+  try {
+    BallotClass ballot(votes, 7);
+  } catch (const std::invalid_argument &e) {
+    return e.what();
+  }
+  return "";
+}
+
+// Status of a row for a ballot type
+BallotStatus statusOf(BallotType type, std::vector<int> votes) {
+  return validateBallot(type, votes.data(), static_cast<int>(votes.size()));
+}
+
+// Every rule reports its own status
+TEST(BallotStatusTests, ValidateTest) {
+  EXPECT_EQ(statusOf(BallotType::STV, {1, 0, 2, 0}), BallotStatus::Valid);
+  EXPECT_EQ(statusOf(BallotType::STV, {1, 0, 0, 0}), BallotStatus::TooFewRanked);
+
+  EXPECT_EQ(statusOf(BallotType::PV, {0, 1, 0}), BallotStatus::Valid);
+  EXPECT_EQ(statusOf(BallotType::PV, {0, 2, 0}), BallotStatus::NonBinaryVote);
+  EXPECT_EQ(statusOf(BallotType::PV, {1, 1, 0}), BallotStatus::NotExactlyOne);
+  EXPECT_EQ(statusOf(BallotType::PV, {0, 0, 0}), BallotStatus::NotExactlyOne);
+
+  EXPECT_EQ(statusOf(BallotType::MV, {1, 1, 0}), BallotStatus::Valid);
+  EXPECT_EQ(statusOf(BallotType::MV, {1, -1, 0}), BallotStatus::NotZeroOrOne);
+
+  EXPECT_EQ(statusOf(BallotType::None, {5, 5}), BallotStatus::Valid);
+}
+
+// Messages are the ones the constructors throw
+TEST(BallotStatusTests, MessageTest) {
+  std::vector<int> stv = {1, 0, 0, 0, 0, 2};
+  EXPECT_EQ(ballotStatusMessage(BallotStatus::TooFewRanked, 7, stv.data(), 6),
+            "\nInvalid STV Ballot 7: Only 2 candidates ranked (minimum 3 required).");
+  EXPECT_EQ(ballotStatusMessage(BallotStatus::TooFewRanked, 7, stv.data(), 6),
+            thrownMessage<STVBallot>(stv));
+
+  std::vector<int> pv = {0, 3, 0};
+  EXPECT_EQ(ballotStatusMessage(BallotStatus::NonBinaryVote, 7, pv.data(), 3),
+            thrownMessage<PluralityBallot>(pv));
+  pv = {1, 1, 0};
+  EXPECT_EQ(ballotStatusMessage(BallotStatus::NotExactlyOne, 7, pv.data(), 3),
+            thrownMessage<PluralityBallot>(pv));
+
+  std::vector<int> mv = {2, 1};
+  EXPECT_EQ(ballotStatusMessage(BallotStatus::NotZeroOrOne, 7, mv.data(), 2),
+            thrownMessage<MVBallot>(mv));
+  EXPECT_STREQ(ballotStatusReason(BallotStatus::NotExactlyOne), "not exactly one 1");
+}
+
+// setBallots keeps the reason of every rejected row
+TEST(BallotStatusTests, InvalidBallotsTest) {
+  Election election({"../../testing/invalid_plurality_ballot.csv"}, "PV", 1);
+  election.setBallots();
+  const std::vector<InvalidBallot> &invalid = election.getInvalidBallots();
+  ASSERT_FALSE(invalid.empty());
+  for (const InvalidBallot &ballot : invalid) {
+    EXPECT_NE(ballot.reason, BallotStatus::Valid);
+    EXPECT_EQ(ballot.reason,
+              statusOf(BallotType::PV, {ballot.votes.begin(), ballot.votes.end()}));
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,179 @@
+/*
+ * File: ballotstore.cpp
+ * Description: Implements the BallotStore class - contiguous storage for the
+ *              votes of every ballot and the Ballot views built over it.
+ */
+
+#include "ballotstore.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+// Constructor
+BallotStore::BallotStore(std::size_t numCandidates)
+    : numCandidates(numCandidates), numRows(0) {}
+
+// Drops rows and views, release the memory too
+void BallotStore::reset(std::size_t numCandidates) {
+  this->numCandidates = numCandidates;
+  numRows = 0;
+  std::vector<int>().swap(votes);
+  std::vector<int>().swap(ids);
+  std::vector<int>().swap(rankings);
+  columns.clear();
+  std::vector<int>().swap(weights);
+  std::vector<std::size_t>().swap(groupStarts);
+  std::vector<int>().swap(memberIDs);
+  std::vector<STVBallot>().swap(stvBallots);
+  std::vector<PluralityBallot>().swap(pluralityBallots);
+  std::vector<MVBallot>().swap(mvBallots);
+}
+
+// Sets the number of rows
+void BallotStore::resize(std::size_t rows) {
+  numRows = rows;
+  votes.resize(rows * numCandidates, 0);
+  ids.resize(rows, 0);
+}
+
+// Appends one ballot
+void BallotStore::addRow(const int *ballotVotes, int ballotID) {
+  votes.insert(votes.end(), ballotVotes, ballotVotes + numCandidates);
+  ids.push_back(ballotID);
+  numRows++;
+}
+
+// Moves every filled range down so the rows are contiguous again
+void BallotStore::compact(const std::vector<std::size_t> &starts,
+                          const std::vector<std::size_t> &counts) {
+  std::size_t next = 0;
+  for (std::size_t i = 0; i < starts.size(); i++) {
+    if (starts[i] != next && counts[i] > 0) {
+      std::copy(row(starts[i]), row(starts[i] + counts[i]), row(next));
+      std::copy(ids.begin() + starts[i], ids.begin() + starts[i] + counts[i],
+                ids.begin() + next);
+    }
+    next += counts[i];
+  }
+  resize(next);
+  votes.shrink_to_fit();
+  ids.shrink_to_fit();
+}
+
+// FNV-1a over the votes of a row
+static std::uint64_t hashRow(const int *row, std::size_t width) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (std::size_t i = 0; i < width; i++) {
+    hash ^= static_cast<std::uint32_t>(row[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash ^ (hash >> 32);
+}
+
+// Open-addressing table of distinct rows - each new row is moved down to the
+// next group slot, which is always a row that was already looked at
+void BallotStore::groupRows() {
+  std::vector<int> groupOf(numRows);
+  std::vector<int> table(std::bit_ceil(std::max<std::size_t>(16, numRows * 2)), -1);
+  const std::size_t mask = table.size() - 1;
+  std::size_t numGroups = 0;
+
+  for (std::size_t i = 0; i < numRows; i++) {
+    std::size_t slot = hashRow(row(i), numCandidates) & mask;
+    while (table[slot] != -1 &&
+           !std::equal(row(i), row(i) + numCandidates, row(table[slot])))
+      slot = (slot + 1) & mask;
+
+    if (table[slot] == -1) {
+      if (numGroups != i)
+        std::copy(row(i), row(i) + numCandidates, row(numGroups));
+      table[slot] = static_cast<int>(numGroups++);
+    }
+    groupOf[i] = table[slot];
+  }
+
+  // Member IDs in CSR form, each group's IDs in ballot order
+  groupStarts.assign(numGroups + 1, 0);
+  for (std::size_t i = 0; i < numRows; i++)
+    groupStarts[groupOf[i] + 1]++;
+  for (std::size_t g = 0; g < numGroups; g++)
+    groupStarts[g + 1] += groupStarts[g];
+  memberIDs.resize(numRows);
+  std::vector<std::size_t> next(groupStarts.begin(), groupStarts.end() - 1);
+  for (std::size_t i = 0; i < numRows; i++)
+    memberIDs[next[groupOf[i]]++] = ids[i];
+
+  weights.resize(numGroups);
+  for (std::size_t g = 0; g < numGroups; g++) {
+    weights[g] = static_cast<int>(groupStarts[g + 1] - groupStarts[g]);
+    ids[g] = memberIDs[groupStarts[g]];
+  }
+  numRows = numGroups;
+  votes.resize(numRows * numCandidates);
+  ids.resize(numRows);
+  votes.shrink_to_fit();
+  ids.shrink_to_fit();
+}
+
+// Builds the views once the rows are final - the matrix must not grow after
+// this or the views would dangle
+std::vector<Ballot *> BallotStore::makeBallots(BallotType type) {
+  std::vector<Ballot *> ballots;
+  ballots.reserve(numRows);
+  const int width = static_cast<int>(numCandidates);
+
+  if (type == BallotType::STV) {
+    stvBallots.clear();
+    stvBallots.reserve(numRows);
+    // Small contests keep the ranking inside each ballot
+    const bool spill = width > STVBallot::inlineRanks;
+    rankings.assign(spill ? votes.size() : 0, 0);
+    for (std::size_t i = 0; i < numRows; i++) {
+      stvBallots.emplace_back(row(i), width, ids[i],
+                              spill ? rankings.data() + i * numCandidates
+                                    : nullptr);
+      stvBallots.back().setWeight(weight(i));
+      ballots.push_back(&stvBallots.back());
+    }
+    columns.clear();
+    if (columnar && RankColumns::paysOff(numCandidates))
+      columns.assign(votes.data(), numRows, numCandidates);
+  } else if (type == BallotType::PV) {
+    pluralityBallots.clear();
+    pluralityBallots.reserve(numRows);
+    for (std::size_t i = 0; i < numRows; i++) {
+      pluralityBallots.emplace_back(row(i), width, ids[i]);
+      pluralityBallots.back().setWeight(weight(i));
+      ballots.push_back(&pluralityBallots.back());
+    }
+  } else if (type == BallotType::MV) {
+    mvBallots.clear();
+    mvBallots.reserve(numRows);
+    for (std::size_t i = 0; i < numRows; i++) {
+      mvBallots.emplace_back(row(i), width, ids[i]);
+      mvBallots.back().setWeight(weight(i));
+      ballots.push_back(&mvBallots.back());
+    }
+  }
+  return ballots;
+}
+
+// Copies of a view share its votes, so the votes pointer gives the row
+std::size_t BallotStore::rowOf(const Ballot *ballot) const {
+  const int *first = ballot->getVotesView().data();
+  const std::size_t offset = static_cast<std::size_t>(
+      reinterpret_cast<std::uintptr_t>(first) -
+      reinterpret_cast<std::uintptr_t>(votes.data())) / sizeof(int);
+  if (numCandidates == 0 || offset >= numRows * numCandidates)
+    return numRows;
+  return offset / numCandidates;
+}
+
+std::vector<std::int64_t> BallotStore::firstPreferenceCounts() const {
+  if (columns.empty())
+    return {};
+  std::vector<std::int64_t> counts(numCandidates, 0);
+  columns.countFirstPreferences(grouped() ? weights.data() : nullptr,
+                                counts.data());
+  return counts;
+}
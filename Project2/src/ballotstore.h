@@ -0,0 +1,183 @@
+/*
+ * File: ballotstore.h
+ * Description: Defines the BallotStore class, which keeps the votes of every
+ *              valid ballot of an election in one contiguous matrix (one row
+ *              per ballot) and hands out lightweight Ballot views over it.
+ */
+
+#ifndef BALLOTSTORE_H
+#define BALLOTSTORE_H
+
+#include "ballot.h"
+#include "ballotstatus.h"
+#include "mvballot.h"
+#include "pluralityballot.h"
+#include "rankcolumns.h"
+#include "stvballot.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @class BallotStore
+ * @brief owns the votes of every ballot of an election in a single matrix
+ */
+class BallotStore {
+private:
+  std::size_t numCandidates; // Row width
+  std::size_t numRows;       // Rows in use
+  std::vector<int> votes;    // numRows x numCandidates, row-major
+  std::vector<int> ids;      // Ballot ID of each row
+  std::vector<int> rankings; // STV ranking order of each row, same shape as
+                             // votes - empty up to STVBallot::inlineRanks
+  bool columnar = false;     // Build rank columns along with STV views
+  RankColumns columns;       // Column-major ranks, built by makeBallots
+
+  // Set by groupRows() - row i then stands for weights[i] identical ballots
+  // whose IDs are memberIDs[groupStarts[i]] .. memberIDs[groupStarts[i+1]-1]
+  std::vector<int> weights;
+  std::vector<std::size_t> groupStarts;
+  std::vector<int> memberIDs;
+
+  // Views handed out by makeBallots(), one vector per ballot type
+  std::vector<STVBallot> stvBallots;
+  std::vector<PluralityBallot> pluralityBallots;
+  std::vector<MVBallot> mvBallots;
+
+public:
+  /**
+   * @brief Constructor for BallotStore
+   * @param numCandidates number of votes per ballot
+   */
+  explicit BallotStore(std::size_t numCandidates = 0);
+
+  /**
+   * @brief drops every row and view and sets the row width
+   * @param numCandidates number of votes per ballot
+   */
+  void reset(std::size_t numCandidates);
+  /**
+   * @brief sets the number of rows, new rows are zeroed
+   * Rows can then be filled in place through row() and setID().
+   * @param rows number of rows
+   */
+  void resize(std::size_t rows);
+  /**
+   * @brief appends a copy of one ballot
+   * @param ballotVotes numCandidates votes
+   * @param ballotID ID of the ballot
+   */
+  void addRow(const int *ballotVotes, int ballotID);
+  /**
+   * @brief closes the gaps left by rows that were reserved but not filled
+   * Range i holds counts[i] filled rows starting at starts[i]; ranges must be
+   * in increasing order. Rows keep their order.
+   * @param starts first row of each range
+   * @param counts filled rows of each range
+   */
+  void compact(const std::vector<std::size_t> &starts,
+               const std::vector<std::size_t> &counts);
+  /**
+   * @brief merges identical rows into one weighted row per distinct ballot
+   * Rows are hashed by their votes; each distinct row keeps its first
+   * occurrence's place and ID, and the IDs of every merged ballot stay
+   * available through members(). Call it once the rows are final.
+   */
+  void groupRows();
+
+  /**
+   * @brief returns the number of ballots
+   * @return rows in the store
+   */
+  std::size_t size() const { return numRows; }
+  /**
+   * @brief returns the number of votes per ballot
+   * @return row width
+   */
+  std::size_t width() const { return numCandidates; }
+  /**
+   * @brief returns the votes of one ballot
+   * @param index row index
+   * @return pointer to width() votes
+   */
+  int *row(std::size_t index) { return votes.data() + index * numCandidates; }
+  const int *row(std::size_t index) const {
+    return votes.data() + index * numCandidates;
+  }
+  /**
+   * @brief returns the ballot ID of a row
+   * @param index row index
+   * @return ballot ID
+   */
+  int id(std::size_t index) const { return ids[index]; }
+  /**
+   * @brief sets the ballot ID of a row
+   * @param index row index
+   * @param ballotID ballot ID
+   */
+  void setID(std::size_t index, int ballotID) { ids[index] = ballotID; }
+  /**
+   * @brief returns true once groupRows() has merged identical rows
+   */
+  bool grouped() const { return !groupStarts.empty(); }
+  /**
+   * @brief returns how many ballots a row stands for
+   * @param index row index
+   * @return 1 unless the rows were grouped
+   */
+  int weight(std::size_t index) const {
+    return grouped() ? weights[index] : 1;
+  }
+  /**
+   * @brief returns the IDs of every ballot a row stands for, in ID order
+   * @param index row index
+   * @return ballot IDs, just id(index) unless the rows were grouped
+   */
+  std::span<const int> members(std::size_t index) const {
+    if (!grouped())
+      return {ids.data() + index, 1};
+    return {memberIDs.data() + groupStarts[index],
+            groupStarts[index + 1] - groupStarts[index]};
+  }
+
+  /**
+   * @brief builds one Ballot view per row
+   * The views point into the store and stay valid until it is reset or
+   * destroyed. Rows must already be valid for the ballot type. Each view
+   * carries its row's weight. STV views also get rank columns when they
+   * are turned on and pay off for the number of candidates.
+   * @param type ballot type to build
+   * @return pointers to the views in row order
+   */
+  std::vector<Ballot *> makeBallots(BallotType type);
+
+  /**
+   * @brief turns per-candidate rank columns on or off
+   * When on, makeBallots(BallotType::STV) also copies the ranks into
+   * rankColumns() if RankColumns::paysOff() for the number of candidates;
+   * wider contests keep the row path alone. The rows stay as they are, so
+   * both layouts are available.
+   * @param columnar true to build rank columns
+   */
+  void setRankColumns(bool columnar) { this->columnar = columnar; }
+  /**
+   * @brief returns the rank columns built by makeBallots
+   * @return columns, empty unless built
+   */
+  const RankColumns &rankColumns() const { return columns; }
+  /**
+   * @brief returns the row a Ballot view (or a copy of one) reads its votes from
+   * @param ballot ballot to look up
+   * @return row index, size() if the ballot's votes are not in the store
+   */
+  std::size_t rowOf(const Ballot *ballot) const;
+  /**
+   * @brief adds up each row's weight by first preference (STV)
+   * Reads the first-preference column when rank columns are built.
+   * @return weighted first preferences per candidate, empty without columns
+   */
+  std::vector<std::int64_t> firstPreferenceCounts() const;
+};
+
+#endif // BALLOTSTORE_H
@@ -0,0 +1,129 @@
+/*
+ * File: ballotstore_UT.cc
+ * Description: Unit tests for the BallotStore class including:
+ *              - Adding and reading rows
+ *              - Compacting partly filled ranges
+ *              - Grouping identical rows
+ *              - Building Ballot views over the rows
+ */
+
+#include "ballotstore.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+// Rows are stored back to back and keep their IDs
+TEST(BallotStoreTests, AddRowTest) {
+  BallotStore store(3);
+  int first[] = {1, 0, 0};
+  int second[] = {0, 2, 1};
+  store.addRow(first, 1);
+  store.addRow(second, 2);
+
+  ASSERT_EQ(store.size(), 2);
+  EXPECT_EQ(store.width(), 3);
+  EXPECT_EQ(store.row(1), store.row(0) + 3);
+  EXPECT_EQ(store.row(1)[1], 2);
+  EXPECT_EQ(store.id(1), 2);
+}
+
+// Gaps between reserved ranges are closed and row order is kept
+TEST(BallotStoreTests, CompactTest) {
+  BallotStore store(2);
+  store.resize(6);
+  // Range 0 = rows 0-2 with 1 filled, range 1 = rows 3-5 with 2 filled
+  store.row(0)[0] = 1;
+  store.setID(0, 10);
+  store.row(3)[1] = 1;
+  store.setID(3, 20);
+  store.row(4)[0] = 1;
+  store.setID(4, 21);
+
+  store.compact({0, 3}, {1, 2});
+  ASSERT_EQ(store.size(), 3);
+  EXPECT_EQ(store.id(0), 10);
+  EXPECT_EQ(store.id(1), 20);
+  EXPECT_EQ(store.id(2), 21);
+  EXPECT_EQ(store.row(1)[1], 1);
+  EXPECT_EQ(store.row(2)[0], 1);
+}
+
+// Identical rows merge into one weighted row that lists every ballot ID
+TEST(BallotStoreTests, GroupRowsTest) {
+  BallotStore store(2);
+  int a[] = {1, 0};
+  int b[] = {0, 1};
+  store.addRow(a, 1);
+  store.addRow(b, 2);
+  store.addRow(a, 4);
+  store.addRow(a, 5);
+  store.addRow(b, 7);
+  EXPECT_FALSE(store.grouped());
+  EXPECT_EQ(store.weight(1), 1);
+
+  store.groupRows();
+  ASSERT_TRUE(store.grouped());
+  ASSERT_EQ(store.size(), 2);
+  EXPECT_EQ(store.row(0)[0], 1);
+  EXPECT_EQ(store.row(1)[1], 1);
+  EXPECT_EQ(store.weight(0), 3);
+  EXPECT_EQ(store.weight(1), 2);
+  EXPECT_EQ(store.id(1), 2);
+  std::span<const int> members = store.members(0);
+  EXPECT_EQ(std::vector<int>(members.begin(), members.end()),
+            (std::vector<int>{1, 4, 5}));
+
+  std::vector<Ballot *> ballots = store.makeBallots(BallotType::PV);
+  ASSERT_EQ(ballots.size(), 2);
+  EXPECT_EQ(ballots[0]->getWeight(), 3);
+  EXPECT_EQ(ballots[1]->getWeight(), 2);
+}
+
+// Views read the votes in place instead of copying them
+TEST(BallotStoreTests, MakeBallotsTest) {
+  BallotStore store(3);
+  int first[] = {2, 1, 3};
+  int second[] = {1, 3, 2};
+  store.addRow(first, 1);
+  store.addRow(second, 2);
+
+  std::vector<Ballot *> ballots = store.makeBallots(BallotType::STV);
+  ASSERT_EQ(ballots.size(), 2);
+  EXPECT_EQ(ballots[1]->getID(), 2);
+  EXPECT_EQ(ballots[0]->getVotes(), (std::vector<int>{2, 1, 3}));
+  EXPECT_EQ(static_cast<STVBallot *>(ballots[0])->getPreference(), 1);
+  EXPECT_EQ(static_cast<STVBallot *>(ballots[1])->getPreference(), 0);
+
+  EXPECT_TRUE(store.makeBallots(BallotType::None).empty());
+}
+
+// Rank columns sit next to the rows and count grouped rows by weight
+TEST(BallotStoreTests, RankColumnsTest) {
+  BallotStore store(3);
+  int first[] = {2, 1, 3};
+  int second[] = {1, 3, 2};
+  store.addRow(first, 1);
+  store.addRow(second, 2);
+  store.addRow(first, 3);
+  store.groupRows();
+
+  std::vector<Ballot *> ballots = store.makeBallots(BallotType::STV);
+  EXPECT_TRUE(store.rankColumns().empty());
+  EXPECT_TRUE(store.firstPreferenceCounts().empty());
+
+  store.setRankColumns(true);
+  ballots = store.makeBallots(BallotType::STV);
+  ASSERT_FALSE(store.rankColumns().empty());
+  EXPECT_EQ(store.rankColumns().rank(2, 1), 2);
+  EXPECT_EQ(store.firstPreferenceCounts(), (std::vector<std::int64_t>{1, 2, 0}));
+
+  EXPECT_EQ(store.rowOf(ballots[1]), 1u);
+  STVBallot copy(*static_cast<STVBallot *>(ballots[1]));
+  EXPECT_EQ(store.rowOf(&copy), 1u);
+  STVBallot outside(std::vector<int>{1, 2, 3}, 9);
+  EXPECT_EQ(store.rowOf(&outside), store.size());
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
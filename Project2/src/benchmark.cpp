@@ -0,0 +1,653 @@
+/*
+ * File: benchmark.cpp
+ * Description: Benchmarks for the election pipeline. Built with `make bench`.
+ *              Usage: ./election_bench ingest [rows] [fixture.csv ...]
+ *                     ./election_bench files [rows] [fixture.csv ...]
+ *                     ./election_bench chunks [rows] [fixture.csv ...]
+ *                     ./election_bench tally [rows] [fixture.csv ...]
+ *                     ./election_bench groups [rows] [fixture.csv ...]
+ *                     ./election_bench approvals [rows] [fixture.csv ...]
+ *                     ./election_bench simd [rows] [candidates ...]
+ *                     ./election_bench shards [rows] [fixture.csv ...]
+ *                     ./election_bench meek [rows] [candidates] [seats]
+ *                     ./election_bench binary [rows] [fixture.csv ...]
+ *                     ./election_bench columns [rows] [fixture.csv ...]
+ *              Fixtures are scaled up to the requested number of ballot rows
+ *              by repeating their ballot lines before timing. The simd
+ *              benchmark uses synthetic MV ballots instead of fixtures, the
+ *              meek benchmark synthetic STV ballots.
+ */
+
+#include "Election.h"
+#include "ballotfile.h"
+#include "meekstv.h"
+#include "mvballot.h"
+#include "parallel.h"
+#include "pluralityballot.h"
+#include "stv.h"
+#include "stvballot.h"
+#include "tallykernel.h"
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <new>
+#include <vector>
+
+// Every heap allocation goes through here so the tally benchmark can count them
+static std::atomic<std::size_t> allocations{0};
+
+void *operator new(std::size_t size) {
+  allocations++;
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+// GCC flags free() here once it inlines the replaced operators - the pair
+// is matched, malloc above and free here
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { ::operator delete(p); }
+#pragma GCC diagnostic pop
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Seconds elapsed since start
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Writes a copy of the fixture with its ballot lines repeated up to rows
+std::string scaleFixture(const std::string &fixture, long rows) {
+  std::ifstream in(fixture);
+  if (!in.is_open())
+    throw std::runtime_error("Failed to open fixture: " + fixture);
+
+  std::vector<std::string> header(5);
+  for (auto &line : header)
+    std::getline(in, line);
+  std::vector<std::string> body;
+  std::string line;
+  while (std::getline(in, line))
+    if (!line.empty())
+      body.push_back(line);
+  if (body.empty())
+    throw std::runtime_error("Fixture has no ballots: " + fixture);
+
+  std::string scaled = fixture.substr(fixture.find_last_of("/\\") + 1);
+  scaled = "bench_" + std::to_string(rows) + "_" + scaled;
+  std::ofstream out(scaled);
+  header[3] = std::to_string(rows);
+  for (const auto &h : header)
+    out << h << '\n';
+  for (long i = 0; i < rows; i++)
+    out << body[i % body.size()] << '\n';
+  return scaled;
+}
+
+// The getline / istringstream / stoi loader setBallots() used before the
+// memory-mapped parser - kept here as the baseline
+std::size_t legacyLoad(const std::string &fileName, const std::string &algorithm,
+                       std::vector<Ballot *> &ballots) {
+  std::ifstream file(fileName);
+  std::string line;
+  for (int i = 0; i < 4; i++)
+    std::getline(file, line);
+  std::getline(file, line);
+  std::istringstream iss(line);
+  std::string name;
+  std::size_t numCandidates = 0;
+  while (std::getline(iss, name, ','))
+    numCandidates++;
+
+  std::size_t invalid = 0;
+  int ballotID = 1;
+  while (std::getline(file, line)) {
+    std::vector<int> votes(numCandidates, 0);
+    std::istringstream ballotStream(line);
+    std::string cell;
+    size_t column = 0;
+    while (std::getline(ballotStream, cell, ',')) {
+      try {
+        if (!cell.empty() && column < numCandidates)
+          votes[column] = std::stoi(cell);
+      } catch (...) {
+        if (column < numCandidates)
+          votes[column] = 0;
+      }
+      column++;
+    }
+    if (column == 0)
+      continue;
+    try {
+      if (algorithm == "STV")
+        ballots.push_back(new STVBallot(votes, ballotID));
+      else if (algorithm == "PV")
+        ballots.push_back(new PluralityBallot(votes, ballotID));
+      else
+        ballots.push_back(new MVBallot(votes, ballotID));
+    } catch (const std::invalid_argument &) {
+      invalid++;
+    }
+    ballotID++;
+  }
+  return invalid;
+}
+
+// Reads the algorithm name from the first header cell
+std::string readAlgorithm(const std::string &fileName) {
+  std::ifstream in(fileName);
+  std::string line;
+  std::getline(in, line);
+  return line.substr(0, line.find_first_of(",\r"));
+}
+
+// Legacy loader vs Election::setBallots() on one scaled fixture
+void benchIngest(const std::string &fixture, long rows) {
+  std::string scaled = scaleFixture(fixture, rows);
+  std::string algorithm = readAlgorithm(scaled);
+
+  // Invalid ballot messages would dominate the timing, drop them
+  std::ofstream devNull;
+  std::streambuf *oldErr = std::cerr.rdbuf(devNull.rdbuf());
+
+  std::vector<Ballot *> legacy;
+  auto start = Clock::now();
+  legacyLoad(scaled, algorithm, legacy);
+  double legacySeconds = secondsSince(start);
+  std::size_t legacyCount = legacy.size();
+  for (auto *b : legacy)
+    delete b;
+
+  Election election({scaled}, algorithm, 1);
+  start = Clock::now();
+  election.setBallots();
+  double mappedSeconds = secondsSince(start);
+
+  std::cerr.rdbuf(oldErr);
+  std::remove(scaled.c_str());
+
+  std::printf("%-36s %10ld rows  legacy %8.3f s  mmap %8.3f s  speedup %5.2fx  "
+              "(%zu / %d valid)\n",
+              fixture.substr(fixture.find_last_of("/\\") + 1).c_str(), rows,
+              legacySeconds, mappedSeconds, legacySeconds / mappedSeconds,
+              legacyCount, election.getNumBallots());
+}
+
+// CSV load vs the same ballots converted to a binary ballot file
+void benchBinary(const std::string &fixture, long rows) {
+  std::string scaled = scaleFixture(fixture, rows);
+  std::string algorithm = readAlgorithm(scaled);
+  std::string converted = scaled + ".ballot";
+
+  std::ofstream devNull;
+  std::streambuf *oldErr = std::cerr.rdbuf(devNull.rdbuf());
+
+  Election csv({scaled}, algorithm, 1);
+  auto start = Clock::now();
+  csv.setBallots();
+  double csvSeconds = secondsSince(start);
+
+  start = Clock::now();
+  BallotFile::write(converted, algorithm, 1, csv.getNames(), csv.getBallots(),
+                    csv.getInvalidBallots());
+  double writeSeconds = secondsSince(start);
+
+  Election binary({converted}, algorithm, 1);
+  start = Clock::now();
+  binary.setBallots();
+  double binarySeconds = secondsSince(start);
+
+  // PV/MV as the app loads them - vote counts only
+  double streamSeconds = 0;
+  if (algorithm != "STV") {
+    Election streamed({converted}, algorithm, 1);
+    streamed.setStreamingTally(true);
+    start = Clock::now();
+    streamed.setBallots();
+    streamSeconds = secondsSince(start);
+  }
+
+  std::cerr.rdbuf(oldErr);
+  std::remove(scaled.c_str());
+  std::remove(converted.c_str());
+
+  std::printf("%-36s %10ld rows  csv %8.3f s  ballot file %8.3f s  "
+              "speedup %6.1fx  streamed %8.3f s  (write %.3f s)\n",
+              fixture.substr(fixture.find_last_of("/\\") + 1).c_str(), rows,
+              csvSeconds, binarySeconds, csvSeconds / binarySeconds,
+              streamSeconds, writeSeconds);
+}
+
+// Loads the fixture split over numFiles files with a growing thread count
+void benchThreads(const std::string &fixture, long rows, int numFiles) {
+  std::string scaled = scaleFixture(fixture, rows / numFiles);
+  std::vector<std::string> files(numFiles, scaled);
+  std::string algorithm = readAlgorithm(scaled);
+
+  std::ofstream devNull;
+  std::streambuf *oldErr = std::cerr.rdbuf(devNull.rdbuf());
+
+  std::printf("%s - %d files, %ld rows\n",
+              fixture.substr(fixture.find_last_of("/\\") + 1).c_str(),
+              numFiles, rows / numFiles * numFiles);
+  double oneThread = 0;
+  int maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+  for (int threads = 1; threads <= std::max(1, maxThreads); threads *= 2) {
+    Election election(files, algorithm, 1);
+    election.setNumThreads(threads);
+    auto start = Clock::now();
+    election.setBallots();
+    double seconds = secondsSince(start);
+    if (threads == 1)
+      oneThread = seconds;
+    std::printf("  %3d threads  %8.3f s  speedup %5.2fx\n", threads, seconds,
+                oneThread / seconds);
+  }
+
+  std::cerr.rdbuf(oldErr);
+  std::remove(scaled.c_str());
+}
+
+// Tally passes reading votes through getVotes() copies vs the in-place view
+void benchTally(const std::string &fixture, long rows) {
+  std::string scaled = scaleFixture(fixture, rows);
+  std::string algorithm = readAlgorithm(scaled);
+
+  std::ofstream devNull;
+  std::streambuf *oldErr = std::cerr.rdbuf(devNull.rdbuf());
+  Election election({scaled}, algorithm, 1);
+  std::vector<Ballot *> ballots = election.setBallots();
+  std::cerr.rdbuf(oldErr);
+  std::remove(scaled.c_str());
+
+  const int passes = 5;
+  std::size_t numCandidates = election.getCandidates().size();
+  std::vector<int> copyCounts(numCandidates, 0);
+  std::vector<int> viewCounts(numCandidates, 0);
+
+  std::size_t before = allocations;
+  auto start = Clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (const Ballot *ballot : ballots) {
+      std::vector<int> votes = ballot->getVotes();
+      for (std::size_t i = 0; i < votes.size(); i++)
+        if (votes[i] == 1)
+          copyCounts[i]++;
+    }
+  }
+  double copySeconds = secondsSince(start) / passes;
+  std::size_t copyAllocations = (allocations - before) / passes;
+
+  before = allocations;
+  start = Clock::now();
+  for (int pass = 0; pass < passes; pass++)
+    Election::countVotes(ballots, viewCounts);
+  double viewSeconds = secondsSince(start) / passes;
+  std::size_t viewAllocations = (allocations - before) / passes;
+
+  std::printf("%-36s %10zu ballots  copy %8.4f s %10zu allocs  "
+              "view %8.4f s %3zu allocs  speedup %5.2fx%s\n",
+              fixture.substr(fixture.find_last_of("/\\") + 1).c_str(),
+              ballots.size(), copySeconds, copyAllocations, viewSeconds,
+              viewAllocations, copySeconds / viewSeconds,
+              copyCounts == viewCounts ? "" : "  COUNTS DIFFER");
+}
+
+// Loading and counting with and without grouping identical ballots
+void benchGroups(const std::string &fixture, long rows) {
+  std::string scaled = scaleFixture(fixture, rows);
+  std::string algorithm = readAlgorithm(scaled);
+
+  std::ofstream devNull;
+  std::streambuf *oldErr = std::cerr.rdbuf(devNull.rdbuf());
+  // STV prints every ballot before counting
+  std::streambuf *oldOut = std::cout.rdbuf(devNull.rdbuf());
+
+  // Runs: single ballots, grouped, grouped with Gregory transfers and the
+  // same on the preference trie (STV only)
+  const int runs = algorithm == "STV" ? 4 : 2;
+  double seconds[4][2];
+  std::size_t numBallots[4];
+  for (int run = 0; run < runs; run++) {
+    const bool grouped = run > 0;
+    Election election({scaled}, algorithm, 2);
+    election.setGroupBallots(grouped);
+    auto start = Clock::now();
+    std::vector<Ballot *> ballots = election.setBallots();
+    seconds[run][0] = secondsSince(start);
+    numBallots[run] = ballots.size();
+
+    start = Clock::now();
+    if (algorithm == "STV") {
+      STV stv(ballots, election.getCandidates(), 2);
+      stv.setShuffle(false);
+      stv.setGregory(run >= 2);
+      stv.setPreferenceTrie(run == 3);
+      std::vector<Candidate *> winners, losers;
+      stv.runElection(winners, losers);
+    } else {
+      std::vector<int> counts(election.getCandidates().size(), 0);
+      Election::countVotes(ballots, counts);
+    }
+    seconds[run][1] = secondsSince(start);
+  }
+
+  std::cout.rdbuf(oldOut);
+  std::cerr.rdbuf(oldErr);
+  std::remove(scaled.c_str());
+
+  std::printf("%-36s %10ld rows\n",
+              fixture.substr(fixture.find_last_of("/\\") + 1).c_str(), rows);
+  const char *names[] = {"single", "grouped", "gregory", "trie"};
+  for (int run = 0; run < runs; run++)
+    std::printf("  %-8s %10zu ballots  load %8.3f s  count %8.4f s\n",
+                names[run], numBallots[run], seconds[run][0], seconds[run][1]);
+}
+
+// PV/MV tally over int rows vs the bit-packed approval matrix
+void benchApprovals(const std::string &fixture, long rows) {
+  std::string scaled = scaleFixture(fixture, rows);
+  std::string algorithm = readAlgorithm(scaled);
+  if (algorithm != "PV" && algorithm != "MV") {
+    std::remove(scaled.c_str());
+    return;
+  }
+
+  std::ofstream devNull;
+  std::streambuf *oldErr = std::cerr.rdbuf(devNull.rdbuf());
+  Election rowsElection({scaled}, algorithm, 1);
+  std::vector<Ballot *> ballots = rowsElection.setBallots();
+  Election packedElection({scaled}, algorithm, 1);
+  packedElection.setPackedApprovals(true);
+  packedElection.setBallots();
+  std::cerr.rdbuf(oldErr);
+  std::remove(scaled.c_str());
+
+  const ApprovalMatrix &approvals = packedElection.getApprovals();
+  const BallotStore &store = rowsElection.getBallotStore();
+  const int passes = 5;
+  std::vector<int> rowCounts;
+  auto start = Clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    rowCounts.assign(store.width(), 0);
+    Election::countVotes(ballots, rowCounts);
+  }
+  double rowSeconds = secondsSince(start) / passes;
+
+  std::vector<int> packedCounts;
+  start = Clock::now();
+  for (int pass = 0; pass < passes; pass++)
+    packedCounts = approvals.tally();
+  double packedSeconds = secondsSince(start) / passes;
+
+  std::size_t rowBytes = store.size() * store.width() * sizeof(int);
+  std::size_t packedBytes = approvals.size() * approvals.words() * 8;
+  std::printf("%-36s %10zu ballots  rows %8.4f s %8.1f MB  "
+              "packed %8.4f s %8.1f MB  speedup %5.2fx%s\n",
+              fixture.substr(fixture.find_last_of("/\\") + 1).c_str(),
+              approvals.size(), rowSeconds, rowBytes / 1e6, packedSeconds,
+              packedBytes / 1e6, rowSeconds / packedSeconds,
+              rowCounts == packedCounts ? "" : "  COUNTS DIFFER");
+}
+
+// Sharded PV/MV tally with a growing thread count
+void benchShards(const std::string &fixture, long rows) {
+  std::string scaled = scaleFixture(fixture, rows);
+  std::string algorithm = readAlgorithm(scaled);
+  if (algorithm != "PV" && algorithm != "MV") {
+    std::remove(scaled.c_str());
+    return;
+  }
+
+  std::ofstream devNull;
+  std::streambuf *oldErr = std::cerr.rdbuf(devNull.rdbuf());
+  Election election({scaled}, algorithm, 1);
+  std::vector<Ballot *> ballots = election.setBallots();
+  std::cerr.rdbuf(oldErr);
+  std::remove(scaled.c_str());
+
+  std::printf("%-36s %10zu ballots\n",
+              fixture.substr(fixture.find_last_of("/\\") + 1).c_str(),
+              ballots.size());
+  const int passes = 5;
+  std::vector<int> expected(election.getCandidates().size(), 0);
+  Election::countVotes(ballots, expected);
+  double oneThread = 0;
+  int maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+  for (int threads = 1; threads <= std::max(1, maxThreads); threads *= 2) {
+    election.setNumThreads(threads);
+    std::vector<int> counts;
+    auto start = Clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+      counts.assign(expected.size(), 0);
+      election.tallyVotes(ballots, counts);
+    }
+    double seconds = secondsSince(start) / passes;
+    if (threads == 1)
+      oneThread = seconds;
+    std::printf("  %3d threads  %8.4f s  speedup %5.2fx%s\n", threads,
+                seconds, oneThread / seconds,
+                counts == expected ? "" : "  COUNTS DIFFER");
+  }
+}
+
+// STV count with first preferences handed out ballot by ballot vs from the
+// store's rank columns
+void benchColumns(const std::string &fixture, long rows) {
+  std::string scaled = scaleFixture(fixture, rows);
+  std::string algorithm = readAlgorithm(scaled);
+  if (algorithm != "STV") {
+    std::remove(scaled.c_str());
+    return;
+  }
+
+  std::ofstream devNull;
+  std::streambuf *oldErr = std::cerr.rdbuf(devNull.rdbuf());
+  std::printf("%-36s %10ld rows\n",
+              fixture.substr(fixture.find_last_of("/\\") + 1).c_str(), rows);
+  std::vector<std::string> results[2];
+  for (int run = 0; run < 2; run++) {
+    const bool columnar = run == 1;
+    Election election({scaled}, algorithm, 2);
+    election.setRankColumns(columnar);
+    auto start = Clock::now();
+    std::vector<Ballot *> ballots = election.setBallots();
+    double loadSeconds = secondsSince(start);
+
+    STV stv(ballots, election.getCandidates(), 2);
+    stv.setShuffle(false);
+    stv.setBatchElimination(true);
+    if (columnar)
+      stv.setBallotStore(&election.getBallotStore());
+    std::vector<Candidate *> winners, losers;
+    start = Clock::now();
+    stv.runElection(winners, losers);
+    double countSeconds = secondsSince(start);
+    for (Candidate *winner : winners)
+      results[run].push_back(winner->getName());
+
+    const RankColumns &columns = election.getBallotStore().rankColumns();
+    const std::size_t bytes =
+        columns.size() * (columns.width() + 1) * columns.bytesPerRank();
+    std::printf("  %-8s %10zu ballots  load %8.3f s  count %8.4f s  "
+                "columns %6.1f MB%s\n",
+                columnar ? "columns" : "rows", ballots.size(), loadSeconds,
+                countSeconds, bytes / 1e6,
+                run == 1 && results[0] != results[1] ? "  WINNERS DIFFER" : "");
+  }
+  std::cerr.rdbuf(oldErr);
+  std::remove(scaled.c_str());
+}
+
+// Column-sum throughput of every tally kernel on synthetic MV ballots
+void benchSimd(long rows, int numCandidates) {
+  BallotStore store(numCandidates);
+  store.resize(rows);
+  std::mt19937 rng(1);
+  for (long r = 0; r < rows; r++) {
+    int *votes = store.row(r);
+    for (int c = 0; c < numCandidates; c++)
+      votes[c] = (rng() >> 7) & 1;
+  }
+  std::vector<Ballot *> ballots = store.makeBallots(BallotType::MV);
+
+  const int passes = 5;
+  const double gigabytes =
+      static_cast<double>(rows) * numCandidates * sizeof(int) / 1e9;
+  std::vector<int> expected(numCandidates, 0);
+  auto start = Clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    expected.assign(numCandidates, 0);
+    Election::countVotes(ballots, expected);
+  }
+  double viewSeconds = secondsSince(start) / passes;
+
+  std::printf("%10ld ballots x %3d candidates  %7.1f MB\n", rows,
+              numCandidates, gigabytes * 1000);
+  std::printf("  %-8s %8.4f s  %6.2f GB/s\n", "views", viewSeconds,
+              gigabytes / viewSeconds);
+  for (tally::Kernel kernel :
+       {tally::Kernel::Scalar, tally::Kernel::SSE42, tally::Kernel::AVX2}) {
+    if (!tally::supported(kernel))
+      continue;
+    std::vector<int> counts;
+    start = Clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+      counts.assign(numCandidates, 0);
+      tally::countOnes(store.row(0), store.size(), store.width(),
+                       counts.data(), kernel);
+    }
+    double seconds = secondsSince(start) / passes;
+    std::printf("  %-8s %8.4f s  %6.2f GB/s  speedup %5.2fx%s\n",
+                tally::kernelName(kernel), seconds, gigabytes / seconds,
+                viewSeconds / seconds,
+                counts == expected ? "" : "  COUNTS DIFFER");
+  }
+}
+
+// Meek STV count of synthetic ranked ballots, round by round. Candidates
+// are ranked in a random order biased towards the lower indices, so some
+// are much stronger than others as in real elections.
+void benchMeek(long rows, int numCandidates, int seats) {
+  BallotStore store(numCandidates);
+  store.resize(rows);
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> uniform(1e-12, 1.0);
+  std::vector<std::pair<double, int>> order(numCandidates);
+  for (long r = 0; r < rows; r++) {
+    for (int c = 0; c < numCandidates; c++)
+      order[c] = {-std::log(uniform(rng)) * (c + 1), c};
+    std::sort(order.begin(), order.end());
+    // At least half the candidates are ranked, as STV ballots need
+    int ranked = numCandidates - static_cast<int>(rng() % (numCandidates / 2 + 1));
+    int *votes = store.row(r);
+    std::fill(votes, votes + numCandidates, 0);
+    for (int rank = 0; rank < ranked; rank++)
+      votes[order[rank].second] = rank + 1;
+  }
+  std::vector<Ballot *> ballots = store.makeBallots(BallotType::STV);
+
+  std::printf("%10ld ballots x %3d candidates, %d seats, %s\n", rows,
+              numCandidates, seats, tally::kernelName(tally::bestKernel()));
+  for (int threads : {1, 0}) {
+    std::vector<Candidate *> candidates;
+    for (int c = 0; c < numCandidates; c++)
+      candidates.push_back(new Candidate("C" + std::to_string(c), c));
+    MeekSTV meek(ballots, candidates, seats);
+    meek.setNumThreads(threads);
+    std::vector<Candidate *> winners, losers;
+    auto start = Clock::now();
+    meek.runElection(winners, losers);
+    double seconds = secondsSince(start);
+
+    int iterations = 0;
+    std::size_t paths = 0;
+    for (const MeekRound &round : meek.getRounds()) {
+      iterations += round.iterations;
+      paths = std::max(paths, round.paths);
+    }
+    std::printf("  %3d threads  %3zu rounds  %5d iterations  %8zu paths max"
+                "  %8.3f s\n",
+                parallel::resolveThreads(threads), meek.getRounds().size(),
+                iterations, paths, seconds);
+    for (Candidate *candidate : candidates)
+      delete candidate;
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string mode = argc > 1 ? argv[1] : "ingest";
+  long rows = argc > 2 ? std::stol(argv[2]) : 10000000;
+  std::vector<std::string> fixtures;
+  for (int i = 3; i < argc; i++)
+    fixtures.push_back(argv[i]);
+  if (fixtures.empty()) {
+    fixtures = {"../testing/plurality_ballots_named_10000.csv",
+                "../testing/mv_ballots_named_10000.csv",
+                "../testing/stv_ballots_named_10000.csv"};
+  }
+
+  try {
+    if (mode == "simd") {
+      std::vector<int> widths = {5, 16};
+      if (argc > 3)
+        widths.clear();
+      for (int i = 3; i < argc; i++)
+        widths.push_back(std::stoi(argv[i]));
+      for (int width : widths)
+        benchSimd(rows, width);
+    } else if (mode == "ingest") {
+      for (const auto &fixture : fixtures)
+        benchIngest(fixture, rows);
+    } else if (mode == "files") {
+      for (const auto &fixture : fixtures)
+        benchThreads(fixture, rows, 64);
+    } else if (mode == "chunks") {
+      for (const auto &fixture : fixtures)
+        benchThreads(fixture, rows, 1);
+    } else if (mode == "tally") {
+      for (const auto &fixture : fixtures)
+        benchTally(fixture, rows);
+    } else if (mode == "groups") {
+      for (const auto &fixture : fixtures)
+        benchGroups(fixture, rows);
+    } else if (mode == "shards") {
+      for (const auto &fixture : fixtures)
+        benchShards(fixture, rows);
+    } else if (mode == "approvals") {
+      for (const auto &fixture : fixtures)
+        benchApprovals(fixture, rows);
+    } else if (mode == "columns") {
+      for (const auto &fixture : fixtures)
+        benchColumns(fixture, rows);
+    } else if (mode == "binary") {
+      for (const auto &fixture : fixtures)
+        benchBinary(fixture, rows);
+    } else if (mode == "meek") {
+      benchMeek(argc > 2 ? rows : 1000000, argc > 3 ? std::stoi(argv[3]) : 50,
+                argc > 4 ? std::stoi(argv[4]) : 10);
+    } else {
+      std::cerr << "Unknown benchmark: " << mode << std::endl;
+      return 1;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * File: csv2ballot.cpp
+ * Description: Converts CSV ballot files into one binary ballot file
+ *              (ballotfile.h) that the election app loads without parsing.
+ *              The CSV files are read by Election::setBallots, so the ballot
+ *              file holds exactly the ballots, IDs and invalid ballots a
+ *              count of the CSV files would use.
+ *              Usage: ./csv2ballot output.ballot input.csv [input.csv ...]
+ */
+
+#include "Election.h"
+#include "ballotfile.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " output.ballot input.csv [input.csv ...]" << std::endl;
+    return 1;
+  }
+  const std::string output = argv[1];
+  std::vector<std::string> inputs(argv + 2, argv + argc);
+
+  try {
+    // Algorithm and seats come from the first file's header
+    std::ifstream first(inputs.front());
+    if (!first.is_open())
+      throw std::runtime_error("Failed to open CSV file: " + inputs.front());
+    std::string line, algorithm;
+    std::getline(first, line);
+    std::istringstream iss(line);
+    std::getline(iss, algorithm, ',');
+    std::getline(first, line);
+    const int seats = std::stoi(line);
+
+    Election election(inputs, algorithm, seats);
+    election.setBallots();
+    BallotFile::write(output, algorithm, seats, election.getNames(),
+                      election.getBallots(), election.getInvalidBallots());
+    std::cout << "Wrote " << election.getBallots().size() << " valid and "
+              << election.getInvalidBallots().size() << " invalid ballots to "
+              << output << std::endl;
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
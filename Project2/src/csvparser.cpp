@@ -0,0 +1,199 @@
+/*
+ * File: csvparser.cpp
+ * Description: Implements the MappedFile class and the in-place csv parsing
+ *              helpers used by Election::setBallots().
+ */
+
+#include "csvparser.h"
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Maps the whole file read-only
+MappedFile::MappedFile(const std::string &fileName)
+    : bytes(nullptr), length(0) {
+#ifdef _WIN32
+  // FOR WINDOWS - no mmap, read the file into a buffer instead
+  std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open CSV file: " + fileName);
+  }
+  buffer.resize(static_cast<std::size_t>(file.tellg()));
+  file.seekg(0);
+  file.read(buffer.data(), buffer.size());
+  bytes = buffer.data();
+  length = buffer.size();
+#else
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open CSV file: " + fileName);
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Failed to read CSV file: " + fileName);
+  }
+  length = static_cast<std::size_t>(info.st_size);
+
+  // mmap rejects zero-length mappings, an empty file is just an empty view
+  if (length > 0) {
+    void *mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("Failed to map CSV file: " + fileName);
+    }
+    // Ballot files are always read front to back
+    ::madvise(mapped, length, MADV_SEQUENTIAL);
+    bytes = static_cast<const char *>(mapped);
+  }
+  ::close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+  if (bytes != nullptr) {
+    ::munmap(const_cast<char *>(bytes), length);
+  }
+#endif
+}
+
+namespace csv {
+
+// Returns the next '\n' terminated line, like std::getline
+bool nextLine(std::string_view text, std::size_t &pos, std::string_view &line) {
+  if (pos >= text.size())
+    return false;
+
+  const char *start = text.data() + pos;
+  const void *newline = std::memchr(start, '\n', text.size() - pos);
+  std::size_t lineLength =
+      newline ? static_cast<const char *>(newline) - start : text.size() - pos;
+
+  line = std::string_view(start, lineLength);
+  pos += lineLength + 1;
+  return true;
+}
+
+// Same rules as std::stoi - leading whitespace, optional sign, digits up to
+// the first other character. Anything stoi would throw on becomes 0.
+int parseCell(std::string_view cell) {
+  const char *first = cell.data();
+  const char *last = first + cell.size();
+
+  while (first != last && (*first == ' ' || (*first >= '\t' && *first <= '\r')))
+    ++first;
+  if (first != last && *first == '+') {
+    ++first;
+    if (first == last || *first < '0' || *first > '9')
+      return 0;
+  }
+
+  int value = 0;
+  auto [ptr, ec] = std::from_chars(first, last, value);
+  if (ec != std::errc())
+    return 0;
+  return value;
+}
+
+// Splits on ',' the way repeated std::getline(stream, cell, ',') does -
+// a trailing ',' does not produce an extra empty cell
+std::size_t parseRow(std::string_view line, int *votes,
+                     std::size_t numCandidates) {
+  std::size_t column = 0;
+  std::size_t pos = 0;
+
+  while (pos < line.size()) {
+    std::size_t comma = line.find(',', pos);
+    if (comma == std::string_view::npos)
+      comma = line.size();
+
+    if (column < numCandidates && comma > pos)
+      votes[column] = parseCell(line.substr(pos, comma - pos));
+    column++;
+    pos = comma + 1;
+  }
+  return column;
+}
+
+// Splits the candidate names header
+std::vector<std::string> splitNames(std::string_view line) {
+  std::vector<std::string> names;
+  std::size_t pos = 0;
+
+  while (pos < line.size()) {
+    std::size_t comma = line.find(',', pos);
+    if (comma == std::string_view::npos)
+      comma = line.size();
+    names.emplace_back(line.substr(pos, comma - pos));
+    pos = comma + 1;
+  }
+  return names;
+}
+
+// Counts non-empty lines with memchr, without looking at the cells
+std::size_t countRows(std::string_view text) {
+  std::size_t rows = 0;
+  std::size_t pos = 0;
+
+  while (pos < text.size()) {
+    const char *start = text.data() + pos;
+    const void *newline = std::memchr(start, '\n', text.size() - pos);
+    std::size_t lineLength =
+        newline ? static_cast<const char *>(newline) - start : text.size() - pos;
+    if (lineLength > 0)
+      rows++;
+    pos += lineLength + 1;
+  }
+  return rows;
+}
+
+// Cuts text every chunkBytes, moving each cut forward to just past a '\n'
+std::vector<std::string_view> splitLines(std::string_view text,
+                                         std::size_t chunkBytes) {
+  std::vector<std::string_view> chunks;
+  if (chunkBytes == 0)
+    chunkBytes = 1;
+  std::size_t begin = 0;
+
+  while (begin < text.size()) {
+    std::size_t end = begin + chunkBytes;
+    if (end >= text.size()) {
+      end = text.size();
+    } else {
+      const void *newline =
+          std::memchr(text.data() + end - 1, '\n', text.size() - end + 1);
+      end = newline ? static_cast<const char *>(newline) - text.data() + 1
+                    : text.size();
+    }
+    chunks.push_back(text.substr(begin, end - begin));
+    begin = end;
+  }
+  return chunks;
+}
+
+// Counts cells with the same splitting rules as splitNames()
+std::size_t countCells(std::string_view line) {
+  std::size_t count = 0;
+  std::size_t pos = 0;
+
+  while (pos < line.size()) {
+    std::size_t comma = line.find(',', pos);
+    if (comma == std::string_view::npos)
+      comma = line.size();
+    count++;
+    pos = comma + 1;
+  }
+  return count;
+}
+
+} // namespace csv
@@ -0,0 +1,116 @@
+/*
+ * File: csvparser.h
+ * Description: Defines the MappedFile class and the csv parsing helpers used to
+ *              load ballot files. Files are memory-mapped and scanned in place,
+ *              so no per-line string or stream objects are created.
+ */
+
+#ifndef CSVPARSER_H
+#define CSVPARSER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class MappedFile
+ * @brief read-only view of a whole file, memory-mapped where the platform allows it
+ */
+class MappedFile {
+private:
+  const char *bytes; // First byte of the file contents
+  std::size_t length; // Number of bytes in the file
+#ifdef _WIN32
+  std::vector<char> buffer; // Windows fallback - file read into memory
+#endif
+
+public:
+  /**
+   * @brief maps the file into memory
+   * @param fileName path of the file to map
+   * @throws std::runtime_error if the file cannot be opened or mapped
+   */
+  explicit MappedFile(const std::string &fileName);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+   * @brief returns the file contents
+   * @return contents as a string_view over the mapped bytes
+   */
+  std::string_view view() const { return {bytes, length}; }
+  /**
+   * @brief returns the size of the file
+   * @return size in bytes
+   */
+  std::size_t size() const { return length; }
+};
+
+// Parsing helpers shared by every ballot loader. They follow the behaviour of
+// std::getline / std::stoi, which the loaders were originally written with.
+namespace csv {
+
+/**
+ * @brief reads the line starting at pos and moves pos past its newline
+ * @param text whole file contents
+ * @param pos offset of the line, updated to the start of the next line
+ * @param line receives the line without its '\n'
+ * @return false once the end of text has been reached
+ */
+bool nextLine(std::string_view text, std::size_t &pos, std::string_view &line);
+
+/**
+ * @brief converts a single cell to an integer the way std::stoi would
+ * @param cell characters of the cell
+ * @return the value, or 0 for empty / malformed / out of range cells
+ */
+int parseCell(std::string_view cell);
+
+/**
+ * @brief parses one ballot line into a vote buffer
+ * @param line ballot line without its newline
+ * @param votes buffer of numCandidates values, must be zeroed by the caller
+ * @param numCandidates number of candidates (cells beyond this are ignored)
+ * @return number of cells on the line (0 for an empty line)
+ */
+std::size_t parseRow(std::string_view line, int *votes,
+                     std::size_t numCandidates);
+
+/**
+ * @brief splits the candidate header line into names
+ * @param line candidate names line
+ * @return names in column order
+ */
+std::vector<std::string> splitNames(std::string_view line);
+
+/**
+ * @brief counts the non-empty lines of text (the lines that become ballots)
+ * @param text ballot section of a file
+ * @return number of ballot rows
+ */
+std::size_t countRows(std::string_view text);
+
+/**
+ * @brief splits text into pieces of roughly chunkBytes that end on a newline
+ * Every line lands whole in exactly one piece, so pieces can be parsed
+ * independently and concatenated.
+ * @param text ballot section of a file
+ * @param chunkBytes target size of each piece
+ * @return pieces in file order
+ */
+std::vector<std::string_view> splitLines(std::string_view text,
+                                         std::size_t chunkBytes);
+
+/**
+ * @brief counts the cells of a header line
+ * @param line header line
+ * @return number of cells
+ */
+std::size_t countCells(std::string_view line);
+
+} // namespace csv
+
+#endif // CSVPARSER_H
@@ -0,0 +1,104 @@
+/*
+ * File: csvparser_UT.cc
+ * Description: Unit tests for the memory-mapped csv parsing helpers including:
+ *              - Line splitting
+ *              - stoi-compatible cell conversion
+ *              - Ballot row parsing
+ *              - Loading a fixture through MappedFile
+ */
+
+#include "csvparser.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Lines are split like std::getline, the last line may lack a newline
+TEST(CSVParserTests, NextLineTest) {
+  std::string_view text = "STV,,\r\n3\n\n1,2";
+  std::size_t pos = 0;
+  std::string_view line;
+
+  ASSERT_TRUE(csv::nextLine(text, pos, line));
+  EXPECT_EQ(line, "STV,,\r");
+  ASSERT_TRUE(csv::nextLine(text, pos, line));
+  EXPECT_EQ(line, "3");
+  ASSERT_TRUE(csv::nextLine(text, pos, line));
+  EXPECT_EQ(line, "");
+  ASSERT_TRUE(csv::nextLine(text, pos, line));
+  EXPECT_EQ(line, "1,2");
+  EXPECT_FALSE(csv::nextLine(text, pos, line));
+}
+
+// Cells convert the same way std::stoi did, failures become 0
+TEST(CSVParserTests, ParseCellTest) {
+  EXPECT_EQ(csv::parseCell("12"), 12);
+  EXPECT_EQ(csv::parseCell(" 3"), 3);
+  EXPECT_EQ(csv::parseCell("+4"), 4);
+  EXPECT_EQ(csv::parseCell("-2"), -2);
+  EXPECT_EQ(csv::parseCell("5\r"), 5);
+  EXPECT_EQ(csv::parseCell("\r"), 0);
+  EXPECT_EQ(csv::parseCell("abc"), 0);
+  EXPECT_EQ(csv::parseCell("+-1"), 0);
+  EXPECT_EQ(csv::parseCell("99999999999"), 0);
+}
+
+// Rows fill the vote buffer and report the getline cell count
+TEST(CSVParserTests, ParseRowTest) {
+  std::vector<int> votes(5, 0);
+  EXPECT_EQ(csv::parseRow("1,,2,,3\r", votes.data(), votes.size()), 5);
+  EXPECT_EQ(votes, (std::vector<int>{1, 0, 2, 0, 3}));
+
+  votes.assign(5, 0);
+  EXPECT_EQ(csv::parseRow("1,2,", votes.data(), votes.size()), 2);
+  EXPECT_EQ(votes, (std::vector<int>{1, 2, 0, 0, 0}));
+
+  // Extra cells are counted but never written past the buffer
+  votes.assign(2, 0);
+  EXPECT_EQ(csv::parseRow("1,0,1", votes.data(), votes.size()), 3);
+  EXPECT_EQ(votes, (std::vector<int>{1, 0}));
+
+  EXPECT_EQ(csv::parseRow("", votes.data(), votes.size()), 0);
+  EXPECT_EQ(csv::parseRow(",", votes.data(), votes.size()), 1);
+}
+
+// Pieces cover the text exactly and never cut a line in two
+TEST(CSVParserTests, SplitLinesTest) {
+  std::string_view text = "1,0\n0,1\n\n1,1\n0,0";
+  for (std::size_t chunkBytes = 1; chunkBytes <= text.size() + 1; chunkBytes++) {
+    std::vector<std::string_view> pieces = csv::splitLines(text, chunkBytes);
+    std::string joined;
+    std::size_t rows = 0;
+    for (std::size_t i = 0; i < pieces.size(); i++) {
+      joined += pieces[i];
+      rows += csv::countRows(pieces[i]);
+      if (i + 1 < pieces.size()) {
+        EXPECT_EQ(pieces[i].back(), '\n');
+      }
+    }
+    EXPECT_EQ(joined, text);
+    EXPECT_EQ(rows, 4);
+  }
+}
+
+// Candidate header splitting
+TEST(CSVParserTests, SplitNamesTest) {
+  std::vector<std::string> names = csv::splitNames("Bill Jones,Alice Mix,C");
+  ASSERT_EQ(names.size(), 3);
+  EXPECT_EQ(names[0], "Bill Jones");
+  EXPECT_EQ(names[2], "C");
+  EXPECT_EQ(csv::countCells("A,B,C,D,"), 4);
+}
+
+// Mapping a real fixture and a missing file
+TEST(CSVParserTests, MappedFileTest) {
+  MappedFile file("../../testing/stv_ballots.csv");
+  EXPECT_GT(file.size(), 0);
+  EXPECT_EQ(file.view().substr(0, 3), "STV");
+  EXPECT_THROW(MappedFile missing("nonexistent_file.csv"), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+/*
+ * File: indexedheap.h
+ * Description: Defines the IndexedMinHeap class template, a binary min-heap
+ *              over items 0..n-1 that also knows where each item sits, so an
+ *              item's key can be changed or the item removed in O(log n).
+ */
+
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @class IndexedMinHeap
+ * @brief min-heap of item indices ordered by a key stored per item
+ * @tparam Key key type, the item with the smallest key is on top
+ * @tparam Compare strict weak ordering on keys
+ */
+template <typename Key, typename Compare = std::less<Key>> class IndexedMinHeap {
+private:
+  std::vector<int> heap;     // Items in heap order
+  std::vector<int> position; // Slot of each item in heap, -1 if not in it
+  std::vector<Key> keys;     // Key of each item
+  Compare less;
+
+  void place(std::size_t slot, int item) {
+    heap[slot] = item;
+    position[item] = static_cast<int>(slot);
+  }
+
+  void siftUp(std::size_t slot) {
+    int item = heap[slot];
+    while (slot > 0) {
+      std::size_t parent = (slot - 1) / 2;
+      if (!less(keys[item], keys[heap[parent]]))
+        break;
+      place(slot, heap[parent]);
+      slot = parent;
+    }
+    place(slot, item);
+  }
+
+  void siftDown(std::size_t slot) {
+    int item = heap[slot];
+    for (;;) {
+      std::size_t child = 2 * slot + 1;
+      if (child >= heap.size())
+        break;
+      if (child + 1 < heap.size() && less(keys[heap[child + 1]], keys[heap[child]]))
+        child++;
+      if (!less(keys[heap[child]], keys[item]))
+        break;
+      place(slot, heap[child]);
+      slot = child;
+    }
+    place(slot, item);
+  }
+
+public:
+  /**
+   * @brief Constructor for IndexedMinHeap
+   * @param capacity number of items, valid items are 0..capacity-1
+   */
+  explicit IndexedMinHeap(std::size_t capacity = 0) { reset(capacity); }
+
+  /**
+   * @brief empties the heap and sets the number of items
+   * @param capacity number of items
+   */
+  void reset(std::size_t capacity) {
+    heap.clear();
+    position.assign(capacity, -1);
+    keys.assign(capacity, Key());
+  }
+
+  /**
+   * @brief returns true if no item is in the heap
+   */
+  bool empty() const { return heap.empty(); }
+  /**
+   * @brief returns the number of items in the heap
+   */
+  std::size_t size() const { return heap.size(); }
+  /**
+   * @brief returns true if the item is in the heap
+   * @param item item index
+   */
+  bool contains(int item) const { return position[item] != -1; }
+  /**
+   * @brief returns the item with the smallest key, the heap must not be empty
+   */
+  int top() const { return heap.front(); }
+  /**
+   * @brief returns the key of an item
+   * @param item item index
+   */
+  const Key &key(int item) const { return keys[item]; }
+
+  /**
+   * @brief adds an item, or changes its key if it is already in the heap
+   * @param item item index
+   * @param key new key
+   */
+  void push(int item, Key key) {
+    if (contains(item)) {
+      update(item, std::move(key));
+      return;
+    }
+    keys[item] = std::move(key);
+    heap.push_back(item);
+    siftUp(heap.size() - 1);
+  }
+
+  /**
+   * @brief changes the key of an item in the heap
+   * @param item item index
+   * @param key new key
+   */
+  void update(int item, Key key) {
+    bool smaller = less(key, keys[item]);
+    keys[item] = std::move(key);
+    if (smaller)
+      siftUp(position[item]);
+    else
+      siftDown(position[item]);
+  }
+
+  /**
+   * @brief removes an item, does nothing if it is not in the heap
+   * @param item item index
+   */
+  void erase(int item) {
+    if (!contains(item))
+      return;
+    std::size_t slot = position[item];
+    int last = heap.back();
+    heap.pop_back();
+    position[item] = -1;
+    if (last == item)
+      return;
+    place(slot, last);
+    siftUp(slot);
+    siftDown(position[last]);
+  }
+
+  /**
+   * @brief removes and returns the item with the smallest key
+   * @return item index
+   */
+  int pop() {
+    int item = top();
+    erase(item);
+    return item;
+  }
+};
+
+#endif // INDEXEDHEAP_H
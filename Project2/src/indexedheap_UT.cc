@@ -0,0 +1,74 @@
+/*
+ * File: indexedheap_UT.cc
+ * Description: Unit tests for the IndexedMinHeap class template including:
+ *              - Ordering by key with index tie-breaks
+ *              - Changing keys of items in the heap
+ *              - Removing items from the middle of the heap
+ */
+
+#include "indexedheap.h"
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+using VoteKey = std::pair<int, int>; // (votes, candidate index) as used by STV
+
+// Smallest key is on top, equal votes fall back to the lower index
+TEST(IndexedHeapTests, OrderTest) {
+  IndexedMinHeap<VoteKey> heap(4);
+  heap.push(0, {5, 0});
+  heap.push(1, {2, 1});
+  heap.push(2, {2, 2});
+  heap.push(3, {7, 3});
+
+  EXPECT_EQ(heap.size(), 4);
+  EXPECT_EQ(heap.pop(), 1);
+  EXPECT_EQ(heap.pop(), 2);
+  EXPECT_EQ(heap.pop(), 0);
+  EXPECT_EQ(heap.pop(), 3);
+  EXPECT_TRUE(heap.empty());
+}
+
+// Keys can go up or down while the item is in the heap
+TEST(IndexedHeapTests, UpdateTest) {
+  IndexedMinHeap<VoteKey> heap(3);
+  for (int i = 0; i < 3; i++)
+    heap.push(i, {0, i});
+
+  heap.update(0, {3, 0});
+  EXPECT_EQ(heap.top(), 1);
+  heap.update(1, {4, 1});
+  EXPECT_EQ(heap.top(), 2);
+  heap.update(0, {-1, 0});
+  EXPECT_EQ(heap.top(), 0);
+  EXPECT_EQ(heap.key(1), VoteKey(4, 1));
+
+  // Pushing an item already in the heap changes its key
+  heap.push(2, {-5, 2});
+  EXPECT_EQ(heap.size(), 3);
+  EXPECT_EQ(heap.top(), 2);
+}
+
+// Removed items leave the rest in order
+TEST(IndexedHeapTests, EraseTest) {
+  IndexedMinHeap<VoteKey> heap(8);
+  std::vector<int> votes = {4, 1, 6, 3, 8, 2, 7, 5};
+  for (int i = 0; i < 8; i++)
+    heap.push(i, {votes[i], i});
+
+  heap.erase(1);
+  heap.erase(4);
+  heap.erase(4); // not in the heap any more
+  EXPECT_FALSE(heap.contains(1));
+  EXPECT_TRUE(heap.contains(0));
+
+  std::vector<int> order;
+  while (!heap.empty())
+    order.push_back(heap.pop());
+  EXPECT_EQ(order, (std::vector<int>{5, 3, 0, 7, 2, 6}));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
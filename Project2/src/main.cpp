@@ -2,7 +2,7 @@
 * File: main.cpp
  * Description: Main function to run the voting system.
  * Handles election setup, ballot processing, and result display.
- * Supports Multi-file csv inputs for Plurality, STV, and MV voting algorithms.
+ * Supports Multi-file csv inputs for Plurality, STV, Meek STV and MV voting algorithms.
  * Author: Anwesha Samaddar, Annabelle Coler
  */
 
@@ -10,34 +10,62 @@
 #include "Election.h"
 #include "plurality.h"
 #include "stv.h"
+#include "meekstv.h"
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <cstring>
 #include <fstream>
 #include "MVlogic.h"
+#include "trace.h"
 
 using namespace std;
 
-int main() {
+int main(int argc, char* argv[]) {
+    // --batch-elimination lets STV eliminate several hopeless candidates in one round
+    bool batchElimination = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--batch-elimination") == 0) {
+            batchElimination = true;
+        } else {
+            cerr << "Usage: " << argv[0] << " [--batch-elimination]" << endl;
+            return 1;
+        }
+    }
+
     // Create the UserInterface object
     UserInterface ui;  
+
+    // Tracing is off unless VOTING_TRACE names categories, see README
+    trace::openFromEnvironment();
     
     try {
         // Get user input and setup election
         ui.getInfo();
 
         Election election(ui.getCsvFileNames(), ui.getAlgorithm(), ui.getNumSeats(), ui.getAuditFileName());
+
+        // PV and MV only need vote counts - count them while loading instead of keeping every ballot
+        election.setStreamingTally(true);
+        // STV reads first preferences from per-candidate rank columns
+        election.setRankColumns(true);
         
         // Load and parse ballots
         election.setBallots();
+
+        // Removed ballots and ballot counts go to the audit file while counting
+        election.beginAudit();
         
-        //election.displayBallotAllocation();
+        // Votes of every ballot, only with VOTING_TRACE=ballot at debug level
+        election.displayBallotAllocation();
           
 
         // Run appropriate election type
         if (ui.getAlgorithm() == "pv" or ui.getAlgorithm() == "PV") {
             // Execute plurality voting
             Plurality plurality(election.getBallots(), election.getCandidates(), election.getNumSeats());
-            plurality.runElection(election.getBallots(), election.getCandidates(), election.getNumSeats());
+            plurality.runElection(election.getVoteCounts(), election.getCandidates(), election.getNumSeats());
 
             // Transfer winners and losers from Plurality to Election
             for (auto* winner : plurality.getWinners()) {
@@ -56,9 +84,12 @@ int main() {
             std::vector<Candidate*> stvLosers;
 
             STV stv(election.getBallots(), election.getCandidates(), election.getNumSeats());
+            stv.setBallotStore(&election.getBallotStore());
 
             // Set ballot shuffle option - by default set as true in userinterface.h
             stv.setShuffle(ui.getShuffleStv());
+            // Off unless --batch-elimination was given, since it changes the published rounds
+            stv.setBatchElimination(batchElimination);
             stv.runElection(stvWinners, stvLosers);
 
             //cout << "UI : "<<ui.getAlgorithm() <<" elcection:"<<election.getAlgorithm()<<" shuffle: "<<ui.getShuffleStv();
@@ -70,14 +101,47 @@ int main() {
             for (auto* loser : stvLosers) {
                 election.addLoser(loser);
             }
+            for (const auto& round : stv.getEliminations()) {
+                election.addEliminationRound(round);
+            }
 
             // Display STV election stats
             election.displayResults();
+        } else if (ui.getAlgorithm() == "meek" or ui.getAlgorithm() == "MEEK"){
+
+            // Execute Meek STV voting
+            std::vector<Candidate*> meekWinners;
+            std::vector<Candidate*> meekLosers;
+
+            MeekSTV meek(election.getBallots(), election.getCandidates(), election.getNumSeats());
+            meek.runElection(meekWinners, meekLosers);
+
+            // Keep-factor iterations and time spent in each round - formatted
+            // on a local stream so cout keeps its own precision
+            for (size_t i = 0; i < meek.getRounds().size(); i++) {
+                const MeekRound& round = meek.getRounds()[i];
+                ostringstream line;
+                line << "Round " << (i + 1) << ": " << round.iterations << " iterations, "
+                     << round.paths << " paths, quota " << fixed << setprecision(3) << round.quota
+                     << ", " << setprecision(4) << round.seconds << " s";
+                cout << line.str() << endl;
+            }
+
+            // Transfer results
+            for (auto* winner : meekWinners) {
+                election.addWinner(winner);
+            }
+            for (auto* loser : meekLosers) {
+                election.addLoser(loser);
+            }
+
+            // Display Meek STV election stats
+            election.displayResults();
         } else if (ui.getAlgorithm() == "mv" or ui.getAlgorithm() == "MV"){
 
             // Execute MV voting
             MV mv(election.getBallots(), election.getCandidates(), election.getNumSeats());
-            mv.runElection(election.getBallots(), election.getCandidates(), election.getNumSeats());
+            mv.runElection(election.getVoteCounts(), election.getCandidates(), election.getNumSeats());
 
             // Transfer winners and losers from MVlogic to Election
             for (auto* winner : mv.getWinners()) {
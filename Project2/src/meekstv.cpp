@@ -0,0 +1,378 @@
+/*
+ * File: meekstv.cpp
+ * Description: Implements the MeekSTV class - path merging, the vectorized
+ *              keep-factor distribution and the round loop of a Meek count.
+ */
+
+#include "meekstv.h"
+#include "parallel.h"
+#include "stvballot.h"
+#include "tallykernel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MEEK_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Ballots per slice when building paths, and paths per slice when handing
+// them out. Fixed sizes keep the sums in the same order on any thread count.
+constexpr std::size_t ballotSlice = 1 << 15;
+constexpr std::size_t pathSlice = 1 << 14;
+
+/**
+ * @brief weighted ballot paths with the same candidates merged
+ * Open addressing over FNV-1a hashes of the candidate sequences.
+ */
+struct PathTable {
+  std::vector<int> items;          // Candidates of every path, back to back
+  std::vector<std::size_t> starts; // Start of each path in items, plus the end
+  std::vector<std::int64_t> weights;
+  std::vector<std::uint64_t> hashes;
+  std::vector<std::uint32_t> slots; // Path index + 1, 0 when empty
+
+  PathTable() : starts{0}, slots(64, 0) {}
+
+  std::size_t size() const { return weights.size(); }
+  std::size_t length(std::size_t p) const { return starts[p + 1] - starts[p]; }
+  const int *path(std::size_t p) const { return items.data() + starts[p]; }
+
+  void add(const int *path, std::size_t length, std::uint64_t hash,
+           std::int64_t weight) {
+    if ((size() + 1) * 2 > slots.size())
+      grow();
+    std::size_t mask = slots.size() - 1;
+    for (std::size_t s = hash & mask;; s = (s + 1) & mask) {
+      if (slots[s] == 0) {
+        slots[s] = static_cast<std::uint32_t>(size() + 1);
+        items.insert(items.end(), path, path + length);
+        starts.push_back(items.size());
+        weights.push_back(weight);
+        hashes.push_back(hash);
+        return;
+      }
+      std::size_t p = slots[s] - 1;
+      if (hashes[p] == hash && this->length(p) == length &&
+          std::equal(path, path + length, this->path(p))) {
+        weights[p] += weight;
+        return;
+      }
+    }
+  }
+
+  void grow() {
+    std::vector<std::uint32_t> bigger(slots.size() * 2, 0);
+    std::size_t mask = bigger.size() - 1;
+    for (std::size_t p = 0; p < size(); p++) {
+      std::size_t s = hashes[p] & mask;
+      while (bigger[s] != 0)
+        s = (s + 1) & mask;
+      bigger[s] = static_cast<std::uint32_t>(p + 1);
+    }
+    slots.swap(bigger);
+  }
+};
+
+inline std::uint64_t fnv(std::uint64_t hash, int candidate) {
+  return (hash ^ static_cast<std::uint32_t>(candidate)) * 0x100000001b3ULL;
+}
+
+// One level of the distribution: each path hands keep[candidate] of what it
+// has left to its candidate at that level
+void shareScalar(const int *level, const double *keep, double *remaining,
+                 double *shares, std::size_t count) {
+  for (std::size_t p = 0; p < count; p++) {
+    double give = remaining[p] * keep[level[p]];
+    shares[p] = give;
+    remaining[p] = remaining[p] - give;
+  }
+}
+
+#ifdef MEEK_X86
+// Same as shareScalar, four paths per step with the keep factors gathered.
+// Multiply and subtract are kept apart so results match the scalar loop.
+__attribute__((target("avx2"))) void
+shareAVX2(const int *level, const double *keep, double *remaining,
+          double *shares, std::size_t count) {
+  // The masked gather with every lane on - the plain one trips a false
+  // uninitialized warning in GCC's header
+  const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+  std::size_t p = 0;
+  for (; p + 4 <= count; p += 4) {
+    __m128i index =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(level + p));
+    __m256d factor =
+        _mm256_mask_i32gather_pd(_mm256_setzero_pd(), keep, index, all, 8);
+    __m256d left = _mm256_loadu_pd(remaining + p);
+    __m256d give = _mm256_mul_pd(left, factor);
+    _mm256_storeu_pd(shares + p, give);
+    _mm256_storeu_pd(remaining + p, _mm256_sub_pd(left, give));
+  }
+  shareScalar(level + p, keep, remaining + p, shares + p, count - p);
+}
+#endif
+
+} // namespace
+
+// Constructor
+MeekSTV::MeekSTV(std::vector<Ballot *> ballots,
+                 std::vector<Candidate *> candidates, int seats)
+    : Election(std::move(ballots), std::move(candidates), seats) {}
+
+// Sets the convergence tolerance
+void MeekSTV::setTolerance(double tolerance) { this->tolerance = tolerance; }
+
+// Rankings are copied out once and kept flat, so the rounds never touch the
+// ballots again
+void MeekSTV::loadRankings() {
+  rankStarts.assign(1, 0);
+  ranked.clear();
+  weights.clear();
+  for (Ballot *ballot : ballots) {
+    STVBallot::Ranking ranking =
+        static_cast<STVBallot *>(ballot)->getRanking();
+    // Sized up front - the ranking's iterators are forward only
+    const std::size_t start = ranked.size();
+    ranked.resize(start + ranking.size());
+    std::copy(ranking.begin(), ranking.end(), ranked.begin() + start);
+    rankStarts.push_back(ranked.size());
+    weights.push_back(ballot->getWeight());
+  }
+  firstLive.assign(rankStarts.begin(), rankStarts.end() - 1);
+}
+
+// A ballot's path is the elected candidates it reaches before its first
+// hopeful, then that hopeful - or the exhausted slot when there is none
+void MeekSTV::buildPaths() {
+  const int exhausted = static_cast<int>(candidates.size()) + 1;
+  const std::size_t numBallots = weights.size();
+  const std::size_t numSlices = (numBallots + ballotSlice - 1) / ballotSlice;
+  std::vector<PathTable> tables(numSlices);
+
+  parallel::forEach(numSlices, numThreads, [&](std::size_t slice) {
+    PathTable &table = tables[slice];
+    std::vector<int> path;
+    const std::size_t end = std::min(numBallots, (slice + 1) * ballotSlice);
+    for (std::size_t b = slice * ballotSlice; b < end; b++) {
+      // Exclusions are final, so the start of the ranking only moves forward
+      std::size_t pos = firstLive[b];
+      while (pos < rankStarts[b + 1] && state[ranked[pos]] == Excluded)
+        pos++;
+      firstLive[b] = pos;
+
+      path.clear();
+      std::uint64_t hash = 0xcbf29ce484222325ULL;
+      int last = exhausted;
+      for (; pos < rankStarts[b + 1]; pos++) {
+        int c = ranked[pos];
+        if (state[c] == Excluded)
+          continue;
+        if (state[c] == Hopeful) {
+          last = c;
+          break;
+        }
+        path.push_back(c);
+        hash = fnv(hash, c);
+      }
+      path.push_back(last);
+      hash = fnv(hash, last);
+      table.add(path.data(), path.size(), hash, weights[b]);
+    }
+  });
+
+  // Merge in slice order so path order does not depend on the threads
+  PathTable merged;
+  for (const PathTable &table : tables) {
+    for (std::size_t p = 0; p < table.size(); p++)
+      merged.add(table.path(p), table.length(p), table.hashes[p],
+                 table.weights[p]);
+  }
+
+  numPaths = merged.size();
+  pathDepth = 0;
+  for (std::size_t p = 0; p < numPaths; p++)
+    pathDepth = std::max(pathDepth, merged.length(p));
+
+  // Short paths are padded with the pass slot, which keeps nothing
+  const int pass = static_cast<int>(candidates.size());
+  pathCandidates.assign(pathDepth * numPaths, pass);
+  pathWeights.resize(numPaths);
+  for (std::size_t p = 0; p < numPaths; p++) {
+    const int *path = merged.path(p);
+    for (std::size_t d = 0; d < merged.length(p); d++)
+      pathCandidates[d * numPaths + p] = path[d];
+    pathWeights[p] = static_cast<double>(merged.weights[p]);
+  }
+  remaining.resize(numPaths);
+  shares.resize(numPaths);
+}
+
+// Each slice of paths adds into its own vote counts, which are summed in
+// slice order afterwards
+void MeekSTV::distribute() {
+  const std::size_t slots = candidates.size() + 2;
+  const std::size_t numSlices = (numPaths + pathSlice - 1) / pathSlice;
+  std::vector<double> sliceVotes(numSlices * slots, 0.0);
+#ifdef MEEK_X86
+  const bool avx2 = tally::bestKernel() == tally::Kernel::AVX2;
+#endif
+
+  parallel::forEach(numSlices, numThreads, [&](std::size_t slice) {
+    const std::size_t begin = slice * pathSlice;
+    const std::size_t count = std::min(numPaths, begin + pathSlice) - begin;
+    double *out = sliceVotes.data() + slice * slots;
+    double *left = remaining.data() + begin;
+    double *give = shares.data() + begin;
+    std::copy_n(pathWeights.data() + begin, count, left);
+
+    for (std::size_t d = 0; d < pathDepth; d++) {
+      const int *level = pathCandidates.data() + d * numPaths + begin;
+#ifdef MEEK_X86
+      if (avx2)
+        shareAVX2(level, keep.data(), left, give, count);
+      else
+#endif
+        shareScalar(level, keep.data(), left, give, count);
+      for (std::size_t p = 0; p < count; p++)
+        out[level[p]] += give[p];
+    }
+  });
+
+  votes.assign(slots, 0.0);
+  for (std::size_t slice = 0; slice < numSlices; slice++)
+    for (std::size_t c = 0; c < slots; c++)
+      votes[c] += sliceVotes[slice * slots + c];
+}
+
+// Keep factors are scaled by quota / votes until every elected candidate
+// holds the quota, within tolerance
+int MeekSTV::converge() {
+  const std::size_t exhausted = candidates.size() + 1;
+  double total = 0;
+  for (double weight : pathWeights)
+    total += weight;
+
+  int iterations = 0;
+  while (true) {
+    distribute();
+    iterations++;
+    quota = (total - votes[exhausted]) / (numSeats + 1);
+
+    // Elected candidates below the quota with nothing left to take back
+    // cannot move and are left out
+    double error = 0;
+    for (std::size_t c = 0; c < candidates.size(); c++) {
+      if (state[c] == Elected && (keep[c] < 1 || votes[c] > quota))
+        error += std::fabs(votes[c] - quota);
+    }
+    if (error <= tolerance * total || iterations >= maxIterations)
+      return iterations;
+
+    for (std::size_t c = 0; c < candidates.size(); c++) {
+      if (state[c] == Elected && votes[c] > 0)
+        keep[c] = std::min(1.0, keep[c] * quota / votes[c]);
+    }
+  }
+}
+
+// Each round converges the keep factors, then elects every hopeful at the
+// quota or excludes the lowest hopeful
+void MeekSTV::runElection(std::vector<Candidate *> &winners,
+                          std::vector<Candidate *> &losers) {
+  const std::size_t numCandidates = candidates.size();
+  state.assign(numCandidates, Hopeful);
+  // Past the candidates: the pass slot keeps nothing, the exhausted slot all
+  keep.assign(numCandidates + 2, 1.0);
+  keep[numCandidates] = 0.0;
+  finalVotes.assign(numCandidates, 0.0);
+  rounds.clear();
+  loadRankings();
+
+  int numElected = 0;
+  while (numElected < numSeats) {
+    auto start = std::chrono::steady_clock::now();
+    MeekRound round;
+
+    std::vector<int> hopeful;
+    for (std::size_t c = 0; c < numCandidates; c++)
+      if (state[c] == Hopeful)
+        hopeful.push_back(static_cast<int>(c));
+
+    buildPaths();
+    round.paths = numPaths;
+    round.iterations = converge();
+    round.quota = quota;
+
+    auto byVotes = [&](int a, int b) {
+      return votes[a] != votes[b] ? votes[a] > votes[b] : a < b;
+    };
+    std::vector<int> elect;
+    if (hopeful.size() <= static_cast<std::size_t>(numSeats - numElected)) {
+      // Candidates <= seats, elect all remaining
+      elect = hopeful;
+    } else {
+      for (int c : hopeful)
+        if (votes[c] >= quota)
+          elect.push_back(c);
+    }
+    std::sort(elect.begin(), elect.end(), byVotes);
+    if (elect.size() > static_cast<std::size_t>(numSeats - numElected))
+      elect.resize(numSeats - numElected);
+
+    if (!elect.empty()) {
+      for (int c : elect) {
+        state[c] = Elected;
+        winners.push_back(candidates[c]);
+        candidates[c]->setWinner(true);
+        numElected++;
+      }
+      round.elected = elect;
+    } else if (!hopeful.empty()) {
+      // Lowest hopeful is excluded, ties go to the earlier candidate
+      int lowest = hopeful.front();
+      for (int c : hopeful)
+        if (votes[c] < votes[lowest])
+          lowest = c;
+      state[lowest] = Excluded;
+      keep[lowest] = 0.0;
+      finalVotes[lowest] = votes[lowest];
+      losers.push_back(candidates[lowest]);
+      candidates[lowest]->setLoser(true);
+      round.excluded = lowest;
+    }
+
+    round.seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    rounds.push_back(round);
+    if (hopeful.empty())
+      break;
+  }
+
+  // Hopefuls left over lose, weakest first after the excluded candidates
+  std::vector<int> rest;
+  for (std::size_t c = 0; c < numCandidates; c++) {
+    if (state[c] != Excluded)
+      finalVotes[c] = votes[c];
+    if (state[c] == Hopeful)
+      rest.push_back(static_cast<int>(c));
+  }
+  std::sort(rest.begin(), rest.end(), [&](int a, int b) {
+    return votes[a] != votes[b] ? votes[a] < votes[b] : a < b;
+  });
+  for (int c : rest) {
+    losers.push_back(candidates[c]);
+    candidates[c]->setLoser(true);
+  }
+
+  for (std::size_t c = 0; c < numCandidates; c++) {
+    int shown = static_cast<int>(std::lround(finalVotes[c]));
+    candidates[c]->updateVotes(std::max(0, shown - candidates[c]->getNumVotes()));
+  }
+}
@@ -0,0 +1,124 @@
+/*
+ * File: meekstv.h
+ * Description: Defines the MeekSTV class, the Meek method of STV. Every
+ *              elected candidate keeps only the share of each ballot it
+ *              needs (its keep factor) and passes the rest on; keep factors
+ *              are iterated to convergence before every election or
+ *              exclusion.
+ */
+
+#ifndef MEEKSTV_H
+#define MEEKSTV_H
+
+#include "Election.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct MeekRound
+ * @brief what happened in one round of a Meek count and what it cost
+ */
+struct MeekRound {
+  std::vector<int> elected; // Candidates elected this round, by index
+  int excluded = -1;        // Candidate excluded this round, -1 if none
+  int iterations = 0;       // Keep-factor iterations until convergence
+  std::size_t paths = 0;    // Distinct ballot paths the iterations ran over
+  double quota = 0;         // Quota after convergence
+  double seconds = 0;       // Wall time of the round
+};
+
+/**
+ * @class MeekSTV
+ * @brief Meek STV election algorithm inheriting from Election
+ * Ballots are STV ballots. Within a round a ballot's share only depends on
+ * the elected candidates it passes through before its first hopeful, so
+ * ballots with the same path are merged into one weighted path and the
+ * keep-factor iterations run over distinct paths only.
+ */
+class MeekSTV : public Election {
+private:
+  enum State : char { Hopeful, Elected, Excluded };
+
+  std::vector<State> state;          // State of each candidate
+  std::vector<double> keep;          // Keep factor of each candidate
+  std::vector<double> votes;         // Votes after the last iteration, plus the pass and exhausted slots
+  std::vector<double> finalVotes;    // Votes shown for each candidate once counted
+  double quota = 0;                  // Quota after the last iteration
+  double tolerance = 1e-9;           // Converged once elected surpluses sum to tolerance x ballots
+  int maxIterations = 1000;          // Iteration limit per round
+  std::vector<MeekRound> rounds;     // One entry per round of the last count
+
+  // Rankings of every ballot in CSR form, built once per count
+  std::vector<std::size_t> rankStarts;
+  std::vector<int> ranked;
+  std::vector<int> weights;
+  std::vector<std::size_t> firstLive; // Ranking position of the first candidate not excluded
+
+  // Paths of the current round, depth-major - level d of path p is
+  // pathCandidates[d * numPaths + p]
+  std::size_t numPaths = 0;
+  std::size_t pathDepth = 0;
+  std::vector<int> pathCandidates;
+  std::vector<double> pathWeights;
+  std::vector<double> remaining; // Share of each path not handed out yet
+  std::vector<double> shares;    // Share handed out at the current level
+
+  /**
+   * @brief copies the rankings and weights out of the ballots
+   */
+  void loadRankings();
+  /**
+   * @brief merges the ballots into weighted paths for the current states
+   * Runs over fixed-size slices of the ballots on the worker threads set by
+   * setNumThreads; slices are merged in order, so the paths and every sum
+   * over them do not depend on the thread count.
+   */
+  void buildPaths();
+  /**
+   * @brief hands out every path once with the current keep factors
+   */
+  void distribute();
+  /**
+   * @brief iterates keep factors until the elected surpluses vanish
+   * @return number of iterations
+   */
+  int converge();
+
+public:
+  /**
+   * @brief Constructor for MeekSTV
+   * @param ballots STV ballots to count
+   * @param candidates candidates up for election
+   * @param seats number of seats up for election
+   */
+  MeekSTV(std::vector<Ballot *> ballots, std::vector<Candidate *> candidates,
+          int seats);
+
+  /**
+   * @brief sets when keep factors count as converged
+   * @param tolerance largest total surplus left, as a share of the ballots
+   */
+  void setTolerance(double tolerance);
+
+  /**
+   * @brief runs the election
+   * Candidate vote counts are set to their rounded Meek votes - at
+   * exclusion for losers, at the end for everyone else.
+   * @param winners is a list of winners
+   * @param losers is a list of losers, in the order they were excluded
+   */
+  void runElection(std::vector<Candidate *> &winners,
+                   std::vector<Candidate *> &losers);
+
+  /**
+   * @brief returns the rounds of the last count
+   * @return one entry per round with its iterations and timing
+   */
+  const std::vector<MeekRound> &getRounds() const { return rounds; }
+  /**
+   * @brief returns the quota at the end of the last count
+   */
+  double getQuota() const { return quota; }
+};
+
+#endif // MEEKSTV_H
@@ -0,0 +1,125 @@
+/*
+ * File: meekstv_UT.cc
+ * Description: Unit tests for the Meek STV count (meekstv.cpp) including:
+ *              - Rounds, keep-factor transfers and the moving quota
+ *              - Electing every hopeful once they fit the seats left
+ *              - Grouped ballots and thread counts giving the same result
+ */
+
+#include "Election.h"
+#include "candidate.h"
+#include "meekstv.h"
+#include "stvballot.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<Candidate *> makeCandidates(int count) {
+  std::vector<Candidate *> cands;
+  for (int i = 0; i < count; i++)
+    cands.push_back(new Candidate(std::string(1, static_cast<char>('A' + i)), i));
+  return cands;
+}
+
+std::vector<std::string> describe(const std::vector<Candidate *> &winners,
+                                  const std::vector<Candidate *> &losers) {
+  std::vector<std::string> result;
+  for (auto *c : winners)
+    result.push_back("W " + c->getName() + " " + std::to_string(c->getNumVotes()));
+  for (auto *c : losers)
+    result.push_back("L " + c->getName() + " " + std::to_string(c->getNumVotes()));
+  return result;
+}
+
+} // namespace
+
+// A is elected at the quota, B goes, and A keeps only 3/5 of the B ballots -
+// the rest exhausts, the quota drops and D reaches it
+TEST(MeekSTVTests, KeepFactorTest) {
+  std::vector<Candidate *> cands = makeCandidates(4);
+  std::vector<Ballot *> ranked = {
+      new STVBallot({1, 0, 2, 0}, 1), // A > C
+      new STVBallot({1, 0, 0, 2}, 2), // A > D
+      new STVBallot({1, 0, 0, 2}, 3), // A > D
+      new STVBallot({2, 1, 0, 0}, 4), // B > A
+      new STVBallot({2, 1, 0, 0}, 5), // B > A
+      new STVBallot({0, 2, 1, 0}, 6), // C > B
+      new STVBallot({0, 2, 1, 0}, 7), // C > B
+      new STVBallot({0, 2, 0, 1}, 8), // D > B
+      new STVBallot({0, 2, 0, 1}, 9)  // D > B
+  };
+  MeekSTV meek(ranked, cands, 2);
+  std::vector<Candidate *> winners, losers;
+  meek.runElection(winners, losers);
+
+  EXPECT_EQ(describe(winners, losers),
+            (std::vector<std::string>{"W A 3", "W D 3", "L B 2", "L C 2"}));
+
+  const std::vector<MeekRound> &rounds = meek.getRounds();
+  ASSERT_EQ(rounds.size(), 3u);
+  EXPECT_EQ(rounds[0].elected, std::vector<int>{0});
+  EXPECT_DOUBLE_EQ(rounds[0].quota, 3.0);
+  EXPECT_EQ(rounds[1].excluded, 1);
+  EXPECT_TRUE(rounds[1].elected.empty());
+  EXPECT_EQ(rounds[2].elected, std::vector<int>{3});
+  EXPECT_GT(rounds[2].iterations, 1);
+  // B's ballots only pass through A, whatever A does not keep exhausts
+  EXPECT_LT(rounds[2].quota, 3.0);
+  EXPECT_NEAR(meek.getQuota(), rounds[2].quota, 1e-12);
+  for (const MeekRound &round : rounds)
+    EXPECT_GE(round.seconds, 0.0);
+
+  for (auto *b : ranked) delete b;
+  for (auto *c : cands) delete c;
+}
+
+// Once the hopefuls fit the seats left they are all elected, most votes first
+TEST(MeekSTVTests, FillSeatsTest) {
+  std::vector<Candidate *> cands = makeCandidates(3);
+  std::vector<Ballot *> ranked = {
+      new STVBallot({0, 1, 2}, 1),
+      new STVBallot({0, 1, 2}, 2),
+      new STVBallot({2, 0, 1}, 3),
+  };
+  MeekSTV meek(ranked, cands, 3);
+  std::vector<Candidate *> winners, losers;
+  meek.runElection(winners, losers);
+
+  EXPECT_EQ(describe(winners, losers),
+            (std::vector<std::string>{"W B 2", "W C 1", "W A 0"}));
+  EXPECT_EQ(meek.getRounds().size(), 1u);
+
+  for (auto *b : ranked) delete b;
+  for (auto *c : cands) delete c;
+}
+
+// Grouped ballots and any thread count give the single-threaded result
+TEST(MeekSTVTests, GroupsAndThreadsTest) {
+  auto run = [](int threads, bool grouping) {
+    Election election({"../../testing/stv_mixed_ballots_300.csv"}, "STV", 2);
+    election.setGroupBallots(grouping);
+    election.setBallots();
+    MeekSTV meek(election.getBallots(), election.getCandidates(), 2);
+    meek.setNumThreads(threads);
+    std::vector<Candidate *> winners, losers;
+    meek.runElection(winners, losers);
+
+    std::vector<std::string> result = describe(winners, losers);
+    for (const MeekRound &round : meek.getRounds())
+      result.push_back(std::to_string(round.iterations) + " " +
+                       std::to_string(round.quota));
+    return result;
+  };
+
+  std::vector<std::string> expected = run(1, false);
+  EXPECT_EQ(run(1, true), expected);
+  EXPECT_EQ(run(4, false), expected);
+  EXPECT_EQ(run(4, true), expected);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -4,38 +4,43 @@
  * Author: Anwesha Samaddar, Hilton Nguyen
  */
  #include "mvballot.h"
+ #include "ballotstatus.h"
  #include <stdexcept>
  #include <algorithm>
 
  
  // Constructor for MV Ballot
  MVBallot::MVBallot(std::vector<int> votes, int ballotID) : Ballot(votes, ballotID) {
+     initialize();
+ }
+
+ // Constructor for a BallotStore row - already validated by the loader
+ MVBallot::MVBallot(int *votes, int numVotes, int ballotID) : Ballot(votes, numVotes, ballotID) {}
+
+ // Validates the ballot
+ void MVBallot::initialize() {
     // Throws invalid_argument if ballot contains invalid votes
-     if (!isValid()) {
-         throw std::invalid_argument("\nInvalid MV ballot "+std::to_string(ballotID)+": Must have only 1's or 0's.");
+     BallotStatus status = validateMV(votes, numVotes);
+     if (status != BallotStatus::Valid) {
+         throw std::invalid_argument(ballotStatusMessage(status, ballotID, votes, numVotes));
      }
-     
+ }
+ 
+ // Gets the preferred candidate indices
+ // Built on demand so a ballot does not hold a second vector
+ std::vector<int> MVBallot::getPreferences() const {
+     std::vector<int> preferences;
      // Store indices of voted candidates (where vote = 1)
-     for (int i = 0; i < votes.size(); i++) {
+     for (int i = 0; i < numVotes; i++) {
          if (votes[i] == 1) {
              preferences.push_back(i);    // Store candidate indices that got votes
          }
      }
- }
- 
- // Gets the preferred candidate indices
- std::vector<int> MVBallot::getPreferences() const {
      return preferences;
  }
  
  // Validates the ballot format
  // returns true if ballot only contains 0s and 1s, false otherwise
  bool MVBallot::isValid() const {
-    // Check each vote is either 0 (no) or 1 (yes)
-    for (int v : votes) {
-        if (v != 0 && v != 1) {  
-            return false;
-        }
-    }
-    return true;  
-}
\ No newline at end of file
+    return validateMV(votes, numVotes) == BallotStatus::Valid;
+}
\ No newline at end of file
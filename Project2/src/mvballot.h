@@ -15,17 +15,29 @@
  */
 class MVBallot : public Ballot {
 private:
-  std::vector<int> preferences; // Multiple candidate preferences
+  /**
+   * @brief Throws invalid_argument if the ballot is not valid
+   */
+  void initialize();
 
 public:
   /**
-   * @brief Constructor for MVBallots
+   * @brief Constructor for MVBallots, throws invalid_argument for an invalid ballot
    * @param votes Votes for this ballot
    * @param ballotID The unique ballotID number
    */
   MVBallot(std::vector<int> votes, int ballotID);
   /**
-   * @brief Getter for preferences of a Ballot
+   * @brief Constructor for a row of a BallotStore
+   * The store only holds rows that passed validateMV(), so the row is not
+   * checked again.
+   * @param votes First vote of the row
+   * @param numVotes Number of votes in the row
+   * @param ballotID The unique ballotID number
+   */
+  MVBallot(int *votes, int numVotes, int ballotID);
+  /**
+   * @brief Getter for preferences of a Ballot (built from the votes on each call)
    * @return A integer vector of preferences
    */
   std::vector<int> getPreferences() const;
@@ -37,4 +49,4 @@ public:
   bool isValid() const;
 };
 
-#endif // MVBALLOT_H
\ No newline at end of file
+#endif // MVBALLOT_H
\ No newline at end of file
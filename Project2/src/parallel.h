@@ -0,0 +1,79 @@
+/*
+ * File: parallel.h
+ * Description: Small helpers for running independent pieces of work (files,
+ *              byte ranges, ballot chunks) on a pool of worker threads.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+/**
+ * @brief turns a requested thread count into the number of threads to use
+ * @param requested thread count, 0 or less means one per hardware thread
+ * @return at least 1
+ */
+inline int resolveThreads(int requested) {
+  if (requested > 0)
+    return requested;
+  unsigned hardware = std::thread::hardware_concurrency();
+  return hardware == 0 ? 1 : static_cast<int>(hardware);
+}
+
+/**
+ * @brief calls fn(i) for every i in [0, count) using up to threads workers
+ * Items are handed out one at a time, so uneven items balance themselves.
+ * The first exception thrown by fn is rethrown on the calling thread.
+ * @param count number of work items
+ * @param threads requested thread count (see resolveThreads)
+ * @param fn callable taking the item index
+ */
+template <typename Fn> void forEach(std::size_t count, int threads, Fn fn) {
+  std::size_t workers =
+      std::min<std::size_t>(count, static_cast<std::size_t>(resolveThreads(threads)));
+  if (workers <= 1) {
+    for (std::size_t i = 0; i < count; i++)
+      fn(i);
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr failure;
+  std::mutex failureLock;
+
+  auto work = [&]() {
+    try {
+      for (std::size_t i = next++; i < count; i = next++)
+        fn(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(failureLock);
+      if (!failure)
+        failure = std::current_exception();
+      next = count; // stop handing out items
+    }
+  };
+
+  // The calling thread works too
+  std::vector<std::thread> pool;
+  for (std::size_t t = 1; t < workers; t++)
+    pool.emplace_back(work);
+  work();
+  for (auto &thread : pool)
+    thread.join();
+
+  if (failure)
+    std::rethrow_exception(failure);
+}
+
+} // namespace parallel
+
+#endif // PARALLEL_H
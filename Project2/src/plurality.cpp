@@ -11,28 +11,28 @@
 #include <iostream>
 #include "plurality.h"
 #include "Election.h"
+#include <utility>
 #include <vector>
 
 //Constructor
 Plurality::Plurality(std::vector<Ballot*> ballots, std::vector<Candidate*> candidates, int seats)
-    : Election(ballots, candidates, seats) {}
+    : Election(std::move(ballots), std::move(candidates), seats) {}
 
 void Plurality::runElection(std::vector<Ballot*> ballots, std::vector<Candidate*> candidates, int seats) {
-    // Initialize random seed
-    std::srand(std::time(0));
-
     // Initialize vote counts for each candidate
     std::vector<int> voteCounts(candidates.size(), 0);
 
-    // Count votes for each candidate
-    for (auto ballot : ballots) {
-        std::vector<int> votes = ballot->getVotes();
-        for (size_t i = 0; i < votes.size(); i++) {
-            if (votes[i] == 1) {
-                voteCounts[i]++;
-            }
-        }
-    }
+    // Count votes for each candidate, on several threads for large elections
+    tallyVotes(ballots, voteCounts);
+
+    runElection(voteCounts, candidates, seats);
+}
+
+// Decides winners and losers from per-candidate vote counts
+// (also used directly by the streaming tally loader)
+void Plurality::runElection(const std::vector<int>& voteCounts, std::vector<Candidate*> candidates, int seats) {
+    // Initialize random seed
+    std::srand(std::time(0));
 
     // Update each candidate's vote count
     for (size_t i = 0; i < candidates.size(); i++) {
@@ -30,6 +30,14 @@ public:
      */
     void runElection(std::vector<Ballot*> ballots, std::vector<Candidate*> candidates, int seats);
 
+    /**
+     * @brief runs the plurality election on votes that were already counted
+     * @param voteCounts is the number of votes per candidate, indexed like candidates
+     * @param candidates is a vector of all candidates
+     * @param seats is the number of seats up for election
+     */
+    void runElection(const std::vector<int>& voteCounts, std::vector<Candidate*> candidates, int seats);
+
 };
 
-#endif // PLURALITY_H
\ No newline at end of file
+#endif // PLURALITY_H
\ No newline at end of file
@@ -6,29 +6,38 @@
  */
 
 #include "pluralityballot.h"
+#include "ballotstatus.h"
 
 #include <stdexcept>
 
 // Constructor - Initialize base class
 PluralityBallot::PluralityBallot(std::vector<int> votes, int ballotID) : Ballot(votes, ballotID) {
-    int voteCount = 0;
-    preference = -1;
+    validate();
+    initialize();
+}
 
-    // Process each vote in the ballot
-    for (int i = 0; i < votes.size(); i++) {
-        if (votes[i] == 1) {
-            preference = i; // Store preferred candidate index
-            voteCount++;
-        } else if (votes[i] != 0) {
-            // Throw invaid argument when values other than 0 or 1 are found in ballots
-            throw std::invalid_argument("\nInvalid Plurality ballot "+std::to_string(ballotID)+": Non-zero/non-one value found.");
-        }
-    }
+// Constructor for a BallotStore row - already validated by the loader
+PluralityBallot::PluralityBallot(int *votes, int numVotes, int ballotID) : Ballot(votes, numVotes, ballotID) {
+    initialize();
+}
 
-    // A valid Plurality ballot must have exactly one '1'
+// Validates the ballot
+void PluralityBallot::validate() const {
     // Throw invaid argument to notify user of invalid ballots
-    if (voteCount != 1) {
-        throw std::invalid_argument("\nInvalid Plurality ballot "+std::to_string(ballotID)+": Exactly one '1' is required.");
+    BallotStatus status = validatePlurality(votes, numVotes);
+    if (status != BallotStatus::Valid) {
+        throw std::invalid_argument(ballotStatusMessage(status, ballotID, votes, numVotes));
+    }
+}
+
+// Stores the preferred candidate
+void PluralityBallot::initialize() {
+    // Store preferred candidate index
+    preference = -1;
+    for (int i = 0; i < numVotes; i++) {
+        if (votes[i] == 1) {
+            preference = i;
+        }
     }
 }
 
@@ -36,4 +45,4 @@ PluralityBallot::PluralityBallot(std::vector<int> votes, int ballotID) : Ballot(
 // Getter implementation
 int PluralityBallot::getPreference() const {
     return preference;
-}
\ No newline at end of file
+}
\ No newline at end of file
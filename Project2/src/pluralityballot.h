@@ -18,12 +18,30 @@ class PluralityBallot : public Ballot {
 private:
     int preference; // Single candidate preference
 
+    /**
+     * @brief throws invalid_argument unless plurality rules hold
+     */
+    void validate() const;
+    /**
+     * @brief stores the preference
+     */
+    void initialize();
+
 public:
     // Constructor
     /**
-     * @brief Constructor for PluralityBallot 
+     * @brief Constructor for PluralityBallot, throws invalid_argument for an invalid ballot
      */
     PluralityBallot(std::vector<int> votes, int ballotID);
+    /**
+     * @brief Constructor for a row of a BallotStore
+     * The store only holds rows that passed validatePlurality(), so the
+     * row is not checked again.
+     * @param votes first vote of the row
+     * @param numVotes number of votes in the row
+     * @param ballotID unique ID for the ballot
+     */
+    PluralityBallot(int *votes, int numVotes, int ballotID);
 
     // Getter
     /** 
@@ -33,4 +51,4 @@ public:
     int getPreference() const;
 };
 
-#endif // PLURALITYBALLOT_H
\ No newline at end of file
+#endif // PLURALITYBALLOT_H
\ No newline at end of file
@@ -0,0 +1,47 @@
+/*
+ * File: preferencetrie.cpp
+ * Description: Implements the PreferenceTrie class.
+ */
+
+#include "preferencetrie.h"
+
+// Constructor
+PreferenceTrie::PreferenceTrie(std::size_t numCandidates) {
+  reset(numCandidates);
+}
+
+// Drops every node but the root
+void PreferenceTrie::reset(std::size_t numCandidates) {
+  this->numCandidates = numCandidates;
+  nodes.assign(1, Node{-1});
+  children.clear();
+}
+
+// Nodes never move, only the lookup goes
+void PreferenceTrie::finish() {
+  std::unordered_map<std::uint64_t, int>().swap(children);
+}
+
+// Ballots through the node less those that go on to a child
+std::int64_t PreferenceTrie::ending(int index) const {
+  std::int64_t passing = 0;
+  for (int c = nodes[index].firstChild; c != -1; c = nodes[c].nextSibling)
+    passing += nodes[c].count;
+  return nodes[index].count - passing;
+}
+
+int PreferenceTrie::child(int parent, int candidate) {
+  const std::uint64_t key =
+      static_cast<std::uint64_t>(parent) * numCandidates + candidate;
+  auto found = children.find(key);
+  if (found != children.end())
+    return found->second;
+
+  const int index = static_cast<int>(nodes.size());
+  Node added{candidate};
+  added.nextSibling = nodes[parent].firstChild;
+  nodes.push_back(added);
+  nodes[parent].firstChild = index;
+  children.emplace(key, index);
+  return index;
+}
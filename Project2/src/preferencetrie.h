@@ -0,0 +1,98 @@
+/*
+ * File: preferencetrie.h
+ * Description: Defines the PreferenceTrie class, which merges STV ballots
+ *              into a tree keyed by their preference sequence. Ballots that
+ *              share their first preferences share nodes, and each node
+ *              counts the ballots that rank at least that far down it.
+ */
+
+#ifndef PREFERENCETRIE_H
+#define PREFERENCETRIE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class PreferenceTrie
+ * @brief ranked ballots merged by common preference prefixes
+ * Node 0 is the root and stands for no preference yet; the children of a
+ * node are the next preferences of the ballots that reach it.
+ */
+class PreferenceTrie {
+public:
+  /**
+   * @brief one preference prefix shared by count ballots
+   */
+  struct Node {
+    int candidate;         // Last preference of the prefix, -1 for the root
+    int firstChild = -1;   // First next preference, -1 if none
+    int nextSibling = -1;  // Next node with the same parent, -1 if none
+    std::int64_t count = 0; // Ballots whose ranking starts with the prefix
+  };
+
+  static constexpr int root = 0;
+
+  /**
+   * @brief Constructor for PreferenceTrie
+   * @param numCandidates number of candidates a ranking can name
+   */
+  explicit PreferenceTrie(std::size_t numCandidates = 0);
+
+  /**
+   * @brief drops every ballot
+   * @param numCandidates number of candidates a ranking can name
+   */
+  void reset(std::size_t numCandidates);
+  /**
+   * @brief adds a ballot
+   * Walks down the ranking, adding nodes where the prefix is new. Takes any
+   * range of candidate indices, so an inline STVBallot ranking is read in
+   * place.
+   * @param ranking candidate indices, most preferred first
+   * @param weight number of identical ballots this one stands for
+   */
+  template <typename Ranking>
+  void add(const Ranking &ranking, std::int64_t weight) {
+    int at = root;
+    nodes[at].count += weight;
+    for (int candidate : ranking) {
+      at = child(at, candidate);
+      nodes[at].count += weight;
+    }
+  }
+  /**
+   * @brief frees the lookup used while adding ballots
+   * Call once the last ballot is added.
+   */
+  void finish();
+
+  /**
+   * @brief returns the number of nodes, root included
+   */
+  std::size_t size() const { return nodes.size(); }
+  /**
+   * @brief returns a node
+   * @param index node index
+   */
+  const Node &node(int index) const { return nodes[index]; }
+  /**
+   * @brief returns the number of ballots that end at a node
+   * @param index node index
+   * @return ballots ranking nobody after the node's prefix
+   */
+  std::int64_t ending(int index) const;
+
+private:
+  std::size_t numCandidates;
+  std::vector<Node> nodes;
+  std::unordered_map<std::uint64_t, int> children; // (parent, candidate) -> child, while adding
+
+  /**
+   * @brief returns the child of parent for a candidate, added if missing
+   */
+  int child(int parent, int candidate);
+};
+
+#endif // PREFERENCETRIE_H
@@ -0,0 +1,87 @@
+/*
+ * File: preferencetrie_UT.cc
+ * Description: Unit tests for the PreferenceTrie class including:
+ *              - Shared first preferences sharing nodes
+ *              - Node counts with weighted ballots
+ *              - Ballots ending part way down a branch
+ */
+
+#include "preferencetrie.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+// Child of a node for a candidate, -1 if there is none
+int findChild(const PreferenceTrie &trie, int node, int candidate) {
+  for (int c = trie.node(node).firstChild; c != -1;
+       c = trie.node(c).nextSibling)
+    if (trie.node(c).candidate == candidate)
+      return c;
+  return -1;
+}
+
+} // namespace
+
+// A > B > C and A > C share the A node only
+TEST(PreferenceTrieTests, SharedPrefixTest) {
+  PreferenceTrie trie(3);
+  std::vector<int> first = {0, 1, 2};
+  std::vector<int> second = {0, 2};
+  trie.add(first, 1);
+  trie.add(second, 1);
+  trie.finish();
+
+  // Root, A, A>B, A>B>C, A>C
+  EXPECT_EQ(trie.size(), 5u);
+  int a = findChild(trie, PreferenceTrie::root, 0);
+  ASSERT_NE(a, -1);
+  EXPECT_EQ(trie.node(a).count, 2);
+  int ab = findChild(trie, a, 1);
+  int ac = findChild(trie, a, 2);
+  ASSERT_NE(ab, -1);
+  ASSERT_NE(ac, -1);
+  EXPECT_EQ(trie.node(ab).count, 1);
+  EXPECT_EQ(trie.node(ac).count, 1);
+  EXPECT_EQ(findChild(trie, PreferenceTrie::root, 1), -1);
+}
+
+// Weights add up on every node of the ranking
+TEST(PreferenceTrieTests, WeightTest) {
+  PreferenceTrie trie(4);
+  std::vector<int> ranking = {3, 1};
+  trie.add(ranking, 5);
+  trie.add(ranking, 2);
+
+  EXPECT_EQ(trie.size(), 3u);
+  EXPECT_EQ(trie.node(PreferenceTrie::root).count, 7);
+  int d = findChild(trie, PreferenceTrie::root, 3);
+  ASSERT_NE(d, -1);
+  EXPECT_EQ(trie.node(d).count, 7);
+  EXPECT_EQ(trie.node(findChild(trie, d, 1)).count, 7);
+}
+
+// Ballots that rank nobody further end at the node
+TEST(PreferenceTrieTests, EndingTest) {
+  PreferenceTrie trie(3);
+  std::vector<int> shorter = {1};
+  std::vector<int> longer = {1, 0};
+  trie.add(shorter, 3);
+  trie.add(longer, 4);
+
+  int b = findChild(trie, PreferenceTrie::root, 1);
+  ASSERT_NE(b, -1);
+  EXPECT_EQ(trie.node(b).count, 7);
+  EXPECT_EQ(trie.ending(b), 3);
+  EXPECT_EQ(trie.ending(findChild(trie, b, 0)), 4);
+  EXPECT_EQ(trie.ending(PreferenceTrie::root), 0);
+
+  trie.reset(3);
+  EXPECT_EQ(trie.size(), 1u);
+  EXPECT_EQ(trie.node(PreferenceTrie::root).count, 0);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,125 @@
+/*
+ * File: rankcolumns.cpp
+ * Description: Implements the RankColumns class - transposing ballot rows
+ *              into per-candidate rank columns and scanning them.
+ */
+
+#include "rankcolumns.h"
+#include <limits>
+
+namespace {
+
+// Transposes the rows, false if a rank does not fit - the top value of T
+// is kept free to mark rows without a first preference
+template <typename T>
+bool transpose(const int *votes, std::size_t rows, std::size_t width,
+               std::vector<T> &ranks) {
+  constexpr int highest = std::numeric_limits<T>::max() - 1;
+  ranks.resize(rows * width);
+  for (std::size_t r = 0; r < rows; r++) {
+    const int *row = votes + r * width;
+    for (std::size_t c = 0; c < width; c++) {
+      int v = row[c] > 0 ? row[c] : 0;
+      if (v > highest)
+        return false;
+      ranks[c * rows + r] = static_cast<T>(v);
+    }
+  }
+  return true;
+}
+
+// Lowest rank of each row, one column at a time - a strictly lower rank
+// replaces the best so far, so ties keep the lower candidate
+template <typename T>
+void findFirst(const std::vector<T> &ranks, std::size_t rows,
+               std::size_t width, std::vector<T> &first) {
+  constexpr T none = std::numeric_limits<T>::max();
+  std::vector<T> best(rows, none);
+  first.assign(rows, none);
+  for (std::size_t c = 0; c < width; c++) {
+    const T *column = ranks.data() + c * rows;
+    for (std::size_t r = 0; r < rows; r++) {
+      T v = column[r];
+      if (v != 0 && v < best[r]) {
+        best[r] = v;
+        first[r] = static_cast<T>(c);
+      }
+    }
+  }
+}
+
+template <typename T>
+void countFirst(const std::vector<T> &first, const int *weights,
+                std::int64_t *counts) {
+  constexpr T none = std::numeric_limits<T>::max();
+  for (std::size_t r = 0; r < first.size(); r++) {
+    if (first[r] != none)
+      counts[first[r]] += weights ? weights[r] : 1;
+  }
+}
+
+} // namespace
+
+// Constructor
+RankColumns::RankColumns() : numRows(0), numCandidates(0), rankBytes(0) {}
+
+// Candidate indices share the rank type, and its top value means none
+int RankColumns::rankBytesFor(std::size_t numCandidates) {
+  if (numCandidates < std::numeric_limits<std::uint8_t>::max())
+    return 1;
+  if (numCandidates < std::numeric_limits<std::uint16_t>::max())
+    return 2;
+  return 0;
+}
+
+bool RankColumns::paysOff(std::size_t numCandidates) {
+  return numCandidates <= maxCandidates && rankBytesFor(numCandidates) != 0;
+}
+
+// Drops the columns, release the memory too
+void RankColumns::clear() {
+  numRows = 0;
+  numCandidates = 0;
+  rankBytes = 0;
+  std::vector<std::uint8_t>().swap(narrowRanks);
+  std::vector<std::uint8_t>().swap(narrowFirst);
+  std::vector<std::uint16_t>().swap(wideRanks);
+  std::vector<std::uint16_t>().swap(wideFirst);
+}
+
+bool RankColumns::assign(const int *votes, std::size_t rows,
+                         std::size_t width) {
+  clear();
+  // Bytes first, shorts when a rank is too high for them
+  int bytes = rankBytesFor(width);
+  if (bytes == 1 && transpose(votes, rows, width, narrowRanks)) {
+    findFirst(narrowRanks, rows, width, narrowFirst);
+  } else if (bytes != 0 && transpose(votes, rows, width, wideRanks)) {
+    std::vector<std::uint8_t>().swap(narrowRanks);
+    findFirst(wideRanks, rows, width, wideFirst);
+    bytes = 2;
+  } else {
+    clear();
+    return false;
+  }
+  numRows = rows;
+  numCandidates = width;
+  rankBytes = bytes;
+  return true;
+}
+
+int RankColumns::firstPreference(std::size_t row) const {
+  if (rankBytes == 1)
+    return narrowFirst[row] == std::numeric_limits<std::uint8_t>::max()
+               ? -1 : narrowFirst[row];
+  return wideFirst[row] == std::numeric_limits<std::uint16_t>::max()
+             ? -1 : wideFirst[row];
+}
+
+void RankColumns::countFirstPreferences(const int *weights,
+                                        std::int64_t *counts) const {
+  if (rankBytes == 1)
+    countFirst(narrowFirst, weights, counts);
+  else if (rankBytes == 2)
+    countFirst(wideFirst, weights, counts);
+}
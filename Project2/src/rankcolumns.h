@@ -0,0 +1,123 @@
+/*
+ * File: rankcolumns.h
+ * Description: Defines the RankColumns class, a column-major copy of the
+ *              ranks of STV ballots - one contiguous column of ranks per
+ *              candidate plus a column holding each ballot's first preference,
+ *              so a scan over one candidate or over first preferences only
+ *              reads one or two bytes per ballot.
+ */
+
+#ifndef RANKCOLUMNS_H
+#define RANKCOLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class RankColumns
+ * @brief per-candidate rank columns of a ballot store
+ * Ranks are kept as uint8 when every rank and candidate index fits in a
+ * byte and as uint16 otherwise; rankBytesFor() picks the width from the
+ * number of candidates. A rank of 0 means the candidate is not ranked.
+ */
+class RankColumns {
+public:
+  /**
+   * @brief widest contest columns are built for by paysOff()
+   */
+  static constexpr std::size_t maxCandidates = 8;
+
+private:
+  std::size_t numRows;        // Ballots in each column
+  std::size_t numCandidates;  // Number of rank columns
+  int rankBytes;              // 1 or 2, 0 while empty
+  std::vector<std::uint8_t> narrowRanks;  // numCandidates x numRows, column-major
+  std::vector<std::uint8_t> narrowFirst;  // First preference of each row
+  std::vector<std::uint16_t> wideRanks;   // Same, for rankBytes == 2
+  std::vector<std::uint16_t> wideFirst;
+
+public:
+  /**
+   * @brief Constructor for RankColumns, starts empty
+   */
+  RankColumns();
+
+  /**
+   * @brief returns the bytes per rank used for a contest
+   * @param numCandidates number of candidates
+   * @return 1 up to 254 candidates, 2 up to 65534, 0 when the columns
+   *         would not fit and the row layout is used alone
+   */
+  static int rankBytesFor(std::size_t numCandidates);
+  /**
+   * @brief returns true when building columns is cheaper than the row path
+   * The transpose writes every rank, so its cost grows with the number of
+   * candidates, while the first-preference pass it saves costs about the
+   * same per ballot at any width. Load plus count broke even at about 12
+   * candidates, so columns are only built up to maxCandidates.
+   * @param numCandidates number of candidates
+   * @return true if the columns are worth building
+   */
+  static bool paysOff(std::size_t numCandidates);
+
+  /**
+   * @brief drops every column
+   */
+  void clear();
+  /**
+   * @brief builds the columns from row-major votes
+   * Votes of 0 or below are unranked. The first preference of a row is its
+   * lowest positive rank, ties going to the lower candidate index, the
+   * order STVBallot ranks them in. Ranks too high for a byte fall back to
+   * uint16 columns.
+   * @param votes rows x width votes, row-major
+   * @param rows number of rows
+   * @param width number of candidates
+   * @return false, leaving the columns empty, when rankBytesFor() rules
+   *         columns out or a rank does not fit in uint16
+   */
+  bool assign(const int *votes, std::size_t rows, std::size_t width);
+
+  /**
+   * @brief returns true when no columns are built
+   */
+  bool empty() const { return rankBytes == 0; }
+  /**
+   * @brief returns the number of rows in each column
+   */
+  std::size_t size() const { return numRows; }
+  /**
+   * @brief returns the number of rank columns
+   */
+  std::size_t width() const { return numCandidates; }
+  /**
+   * @brief returns the bytes per rank, 0 while empty
+   */
+  int bytesPerRank() const { return rankBytes; }
+  /**
+   * @brief returns the rank a row gives a candidate
+   * @param candidate candidate index
+   * @param row row index
+   * @return rank, 0 if the candidate is not ranked
+   */
+  int rank(std::size_t candidate, std::size_t row) const {
+    return rankBytes == 1 ? narrowRanks[candidate * numRows + row]
+                          : wideRanks[candidate * numRows + row];
+  }
+  /**
+   * @brief returns the first preference of a row
+   * @param row row index
+   * @return candidate index, -1 if the row ranks nobody
+   */
+  int firstPreference(std::size_t row) const;
+  /**
+   * @brief adds each row's weight to its first preference
+   * Only reads the first-preference column.
+   * @param weights weight of each row, null for 1 each
+   * @param counts per-candidate counts to add to, width() entries
+   */
+  void countFirstPreferences(const int *weights, std::int64_t *counts) const;
+};
+
+#endif // RANKCOLUMNS_H
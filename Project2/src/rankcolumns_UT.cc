@@ -0,0 +1,78 @@
+/*
+ * File: rankcolumns_UT.cc
+ * Description: Unit tests for the RankColumns class including:
+ *              - Ranks laid out one column per candidate
+ *              - First preferences, ties and unranked rows
+ *              - Falling back to 16-bit ranks
+ */
+
+#include "rankcolumns.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+// Each candidate's ranks are read back from its own column
+TEST(RankColumnsTests, ColumnTest) {
+  std::vector<int> votes = {2, 1, 3,
+                            1, 0, -1,
+                            0, 0, 0};
+  RankColumns columns;
+  ASSERT_TRUE(columns.assign(votes.data(), 3, 3));
+  EXPECT_EQ(columns.bytesPerRank(), 1);
+  EXPECT_EQ(columns.size(), 3u);
+  EXPECT_EQ(columns.width(), 3u);
+  EXPECT_EQ(columns.rank(0, 0), 2);
+  EXPECT_EQ(columns.rank(2, 0), 3);
+  EXPECT_EQ(columns.rank(0, 1), 1);
+  EXPECT_EQ(columns.rank(2, 1), 0); // Negative votes are unranked
+
+  EXPECT_EQ(columns.firstPreference(0), 1);
+  EXPECT_EQ(columns.firstPreference(1), 0);
+  EXPECT_EQ(columns.firstPreference(2), -1);
+
+  columns.clear();
+  EXPECT_TRUE(columns.empty());
+}
+
+// Equal ranks go to the lower candidate, as in STVBallot's ranking
+TEST(RankColumnsTests, FirstPreferenceTest) {
+  std::vector<int> votes = {0, 2, 2, 3,
+                            4, 0, 1, 1};
+  RankColumns columns;
+  ASSERT_TRUE(columns.assign(votes.data(), 2, 4));
+  EXPECT_EQ(columns.firstPreference(0), 1);
+  EXPECT_EQ(columns.firstPreference(1), 2);
+
+  std::vector<std::int64_t> counts(4, 0);
+  columns.countFirstPreferences(nullptr, counts.data());
+  EXPECT_EQ(counts, (std::vector<std::int64_t>{0, 1, 1, 0}));
+  int weights[] = {5, 2};
+  columns.countFirstPreferences(weights, counts.data());
+  EXPECT_EQ(counts, (std::vector<std::int64_t>{0, 6, 3, 0}));
+}
+
+// Ranks too high for a byte are kept as shorts
+TEST(RankColumnsTests, WidthTest) {
+  EXPECT_EQ(RankColumns::rankBytesFor(5), 1);
+  EXPECT_EQ(RankColumns::rankBytesFor(254), 1);
+  EXPECT_EQ(RankColumns::rankBytesFor(255), 2);
+  EXPECT_EQ(RankColumns::rankBytesFor(70000), 0);
+  EXPECT_TRUE(RankColumns::paysOff(5));
+  EXPECT_TRUE(RankColumns::paysOff(RankColumns::maxCandidates));
+  EXPECT_FALSE(RankColumns::paysOff(RankColumns::maxCandidates + 1));
+
+  std::vector<int> votes = {300, 1};
+  RankColumns columns;
+  ASSERT_TRUE(columns.assign(votes.data(), 1, 2));
+  EXPECT_EQ(columns.bytesPerRank(), 2);
+  EXPECT_EQ(columns.rank(0, 0), 300);
+  EXPECT_EQ(columns.firstPreference(0), 1);
+
+  votes = {70000, 1};
+  EXPECT_FALSE(columns.assign(votes.data(), 1, 2));
+  EXPECT_TRUE(columns.empty());
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,15 +14,19 @@
  #include <unordered_map>
  #include <numeric>
  #include <iostream>
+ #include "parallel.h"
+ #include "trace.h"
+ #include <sstream>
 
  
 using namespace std;
 
  // Constructor - initializes election parameters
  STV::STV(std::vector<Ballot*> ballots, std::vector<Candidate*> candidates, int seats)
-     : Election(ballots, candidates, seats),
-       eliminated(candidates.size(), false),
-       candidateBallots(candidates.size()) {}
+     : Election(std::move(ballots), std::move(candidates), seats),
+       eliminated(this->candidates.size(), false),
+       candidateBallots(this->candidates.size()),
+       fractions(this->candidates.size(), 0) {}
  
 
 // Enable or disable ballot shuffling for randomizing tiebreaks
@@ -33,25 +37,61 @@ void STV::setShuffle(bool shuffle) {
         std::mt19937 g(rd());
         std::shuffle(ballots.begin(), ballots.end(), g);
     }
-    // Debug statements
-    
-    // std::cout << "shuffle set to: "<<shuffle;
-    // std::cout << "Shuffle is " << (shuffle ? "ENABLED" : "DISABLED") << std::endl;
-    // std::cout << shuffle;
-    
+    TRACE(trace::Shuffle, trace::Level::Info,
+          "shuffle " << (shuffle ? "enabled" : "disabled"));
+}
+
+void STV::setGregory(bool gregory) {
+    this->gregory = gregory;
+}
+
+void STV::setPreferenceTrie(bool trie) {
+    useTrie = trie;
+}
+
+void STV::setBatchElimination(bool batch) {
+    batchElimination = batch;
+}
+
+void STV::setBallotStore(const BallotStore* store) {
+    this->store = store;
+}
+
+namespace {
+
+// Votes a ballot carries, all copies at its current value
+std::int64_t ballotValue(const STVBallot* ballot) {
+    return static_cast<std::int64_t>(ballot->getWeight()) * ballot->getValue();
+}
+
+// a * b / c rounded down, without overflowing the product
+std::int64_t mulDiv(std::int64_t a, std::int64_t b, std::int64_t c) {
+#ifdef __SIZEOF_INT128__
+    return static_cast<std::int64_t>(static_cast<__int128>(a) * b / c);
+#else
+    return static_cast<std::int64_t>(static_cast<long double>(a) * b / c);
+#endif
 }
 
+} // namespace
+
 // Calculate the Droop quota - minimum votes needed to win a seat
  int STV::calculateDroop() const {
-     return (ballots.size() / (getNumSeats() + 1)) + 1;
+     return (getNumBallots() / (getNumSeats() + 1)) + 1;
  }
 
 
 // Redistribute surplus votes from an elected candidate
  void STV::redistributeSurplus(Candidate* winner, int droop) {
+     if (gregory) {
+         redistributeSurplusGregory(winner, droop);
+         return;
+     }
     // Calculate surplus votes
      int surplus = winner->getNumVotes() - droop;
      int count = 0;
+     TRACE(trace::Transfer, trace::Level::Info,
+           "surplus of " << winner->getName() << ": " << surplus << " votes");
  
      for (auto& ballot : candidateBallots[winner->getCandidateID()]) {
         // Stop after redistributing surplus
@@ -59,77 +99,370 @@ void STV::setShuffle(bool shuffle) {
  
          STVBallot* stvBallot = static_cast<STVBallot*>(ballot);
 
-        // Move to next preference
-         stvBallot->removeTopChoice();
-         int newPref = stvBallot->getPreference();
-        
-        // Add to new candidate if preference is valid 
-         if (newPref != -1 && !eliminated[newPref]) {
-             candidateBallots[newPref].push_back(ballot);
-             candidates[newPref]->updateVotes(1);
-             
-             // Check for immediate election
-             if (candidates[newPref]->getNumVotes() >= droop) {
-                 winners.push_back(candidates[newPref]);
-                 eliminated[newPref] = true;
-                 candidateBallots[newPref].clear();
-             }
+        // Only the part of a grouped ballot that fits in the surplus moves
+         if (stvBallot->getWeight() > surplus - count) {
+             stvBallot = splitBallot(stvBallot, surplus - count);
          }
-         count++;
+         count += stvBallot->getWeight();
+
+        // Move to next preference still in the count, add to new candidate
+        // if preference is valid - with an immediate election check
+         stvBallot->advance(eliminated);
+         deliver(stvBallot, droop, electedList ? *electedList : winners, true);
      }
  }
 
 
 
+// Gregory (weighted inclusive) transfer - every ballot of the winner moves on
+// at surplus / votes of its value, rounded down in fixed-point. Grouped
+// ballots move as one, so a transfer costs one step per distinct ranking.
+ void STV::redistributeSurplusGregory(Candidate* winner, int droop) {
+     int index = winner->getCandidateID();
+     std::int64_t total = tally(index);
+     std::int64_t surplus = total - static_cast<std::int64_t>(droop) * STVBallot::fullValue;
+     if (surplus <= 0) return;
+     std::int64_t transferValue = mulDiv(surplus, STVBallot::fullValue, total);
+     TRACE(trace::Transfer, trace::Level::Info,
+           "surplus of " << winner->getName() << ": " << surplus << " of " << total
+                         << " at transfer value " << transferValue << "/"
+                         << STVBallot::fullValue);
+     if (useTrie) {
+         transferNodes(index, transferValue);
+         return;
+     }
+
+     std::vector<Ballot*> pile;
+     pile.swap(candidateBallots[index]);
+     for (auto* ballot : pile) {
+         STVBallot* stvBallot = static_cast<STVBallot*>(ballot);
+         stvBallot->setValue(static_cast<int>(
+             mulDiv(stvBallot->getValue(), transferValue, STVBallot::fullValue)));
+         if (stvBallot->getValue() == 0) continue; // rounded away
+
+         // No immediate election - a candidate passing the quota here is
+         // elected in the next round with its own surplus moved on
+         int newPref = stvBallot->advance(eliminated);
+         if (newPref != -1) {
+             candidateBallots[newPref].push_back(ballot);
+             addVotes(newPref, ballotValue(stvBallot));
+         }
+     }
+ }
+
 // Find the candidate with the fewest votes (for elimination)
- Candidate* STV::findLowestCandidate() const {
-     int minVotes = INT_MAX;
-     Candidate* lowest = nullptr;
-     int lastReceipt = -1;
-     std::unordered_map<int, int> receiptTracker;
- 
-     // Initialize receipt tracking
-     for (auto* c : candidates) {
-         receiptTracker[c->getCandidateID()] = -1;
+// Ties go to the earliest candidate in the list
+ Candidate* STV::findLowestCandidate() {
+     if (!hopefulsReady) buildHopefuls();
+     return hopefuls.empty() ? nullptr : candidates[hopefuls.top()];
+ }
+
+// Hopefuls from the fewest votes up - the lowest k go together when their
+// total is below the (k+1)th candidate's, the largest such k is taken. The
+// total starts from the surplus still to be transferred, which could go to
+// any of them
+ std::vector<int> STV::findHopeless(int remainingSeats) const {
+     std::vector<int> order;
+     for (size_t i = 0; i < candidates.size(); ++i) {
+         if (hopefuls.contains(i)) order.push_back(static_cast<int>(i));
      }
- 
-     // Find lowest candidate with tiebreaker  
-     for (auto* c : candidates) {
-         if (!eliminated[c->getCandidateID()] && !c->isWinner()) {
-            // Tiebreaker: earlier ballot receipt wins
-             if (c->getNumVotes() < minVotes || 
-                (c->getNumVotes() == minVotes && 
-                 receiptTracker[c->getCandidateID()] > lastReceipt)) {
-                 minVotes = c->getNumVotes();
-                 lowest = c;
-                 lastReceipt = receiptTracker[c->getCandidateID()];
-             }
+     std::sort(order.begin(), order.end(), [&](int a, int b) {
+         return std::make_pair(tally(a), a) < std::make_pair(tally(b), b);
+     });
+
+     size_t batch = 0;
+     std::int64_t total = pendingSurplus();
+     const size_t most = order.size() > static_cast<size_t>(remainingSeats)
+                             ? order.size() - remainingSeats : 0;
+     for (size_t k = 0; k < most; ++k) {
+         total += tally(order[k]);
+         if (total < tally(order[k + 1])) batch = k + 1;
+     }
+     order.resize(batch);
+     return order;
+ }
+
+// Surpluses move on when their candidate is elected, so only hopefuls that
+// reached the quota during a transfer and wait for the next round hold one
+ std::int64_t STV::pendingSurplus() const {
+     const std::int64_t quota = static_cast<std::int64_t>(droop) * STVBallot::fullValue;
+     std::int64_t surplus = 0;
+     for (int i : quotaReached) {
+         if (hopefuls.contains(i) && tally(i) > quota) surplus += tally(i) - quota;
+     }
+     return surplus;
+ }
+
+// Fill the heap with every candidate still in the count
+ void STV::buildHopefuls() {
+     hopefuls.reset(candidates.size());
+     for (size_t i = 0; i < candidates.size(); ++i) {
+         if (!eliminated[i] && !candidates[i]->isWinner()) {
+             hopefuls.push(i, {tally(i), static_cast<int>(i)});
          }
      }
-     return lowest;
+     hopefulsReady = true;
+ }
+
+// Whole votes plus the fraction carried over from fractional transfers
+ std::int64_t STV::tally(int index) const {
+     return static_cast<std::int64_t>(candidates[index]->getNumVotes()) * STVBallot::fullValue +
+            fractions[index];
+ }
+
+// More votes for a candidate - moves it down the heap
+ void STV::addVotes(int index, std::int64_t value) {
+     int before = candidates[index]->getNumVotes();
+     std::int64_t total = fractions[index] + value;
+     candidates[index]->updateVotes(static_cast<int>(total / STVBallot::fullValue));
+     fractions[index] = total % STVBallot::fullValue;
+     int votes = candidates[index]->getNumVotes();
+     if (hopefuls.contains(index)) {
+         hopefuls.update(index, {tally(index), index});
+         // Remember it for the next round's quota check
+         if (votes >= droop && before < droop) quotaReached.push_back(index);
+     }
+ }
+
+// Elected or eliminated - no longer receives ballots
+ void STV::removeHopeful(int index) {
+     eliminated[index] = true;
+     hopefuls.erase(index);
+ }
+
+// Hand a ballot to its preference - a grouped ballot that takes a candidate
+// past the quota only gives it the votes it needs, the rest moves on
+ void STV::deliver(STVBallot* ballot, int droop, std::vector<Candidate*>& elected,
+                   bool clearPile) {
+     int pref = ballot->skipExcluded(eliminated);
+     while (pref != -1) {
+         // A hopeful already at the quota still takes one ballot before it
+         // is elected
+         // Copies that fit under the quota, at the ballot's value
+         STVBallot* rest = nullptr;
+         std::int64_t needed = static_cast<std::int64_t>(droop) * STVBallot::fullValue - tally(pref);
+         std::int64_t value = std::max(1, ballot->getValue());
+         int room = static_cast<int>(std::max<std::int64_t>(1, (needed + value - 1) / value));
+         if (ballot->getWeight() > room) {
+             rest = splitBallot(ballot, ballot->getWeight() - room);
+         }
+         candidateBallots[pref].push_back(ballot);
+         addVotes(pref, ballotValue(ballot));
+
+         // Immediate election check, while seats are left
+         if (candidates[pref]->getNumVotes() >= droop &&
+             elected.size() < static_cast<size_t>(getNumSeats())) {
+             elected.push_back(candidates[pref]);
+             removeHopeful(pref);
+             TRACE(trace::Round, trace::Level::Info,
+                   "elected " << candidates[pref]->getName() << " on reaching quota "
+                              << droop << " mid-transfer");
+             if (clearPile) candidateBallots[pref].clear();
+         }
+         if (!rest) break;
+         ballot = rest;
+         pref = ballot->skipExcluded(eliminated);
+     }
+ }
+
+// The copy shares the votes and ranking, only the weight is divided
+ STVBallot* STV::splitBallot(STVBallot* ballot, int weight) {
+     splitBallots.push_back(*ballot);
+     splitOrigins.push_back(ballot);
+     splitBallots.back().setWeight(weight);
+     ballot->setWeight(ballot->getWeight() - weight);
+     return &splitBallots.back();
  }
  
 
  // Redistribute votes from an eliminated candidate
  void STV::redistributeEliminated(Candidate* eliminatedCandidate) {
      size_t elimID = eliminatedCandidate->getCandidateID();
-    
+     if (gregory && useTrie) {
+         transferNodes(elimID, STVBallot::fullValue);
+         return;
+     }
+     std::vector<Ballot*>& pile = candidateBallots[elimID];
+
+     // Large piles are transferred on several threads
+     const size_t shards = std::min<size_t>(
+         parallel::resolveThreads(numThreads),
+         pile.size() / std::max(1, tallyThreshold));
+     TRACE(trace::Transfer, trace::Level::Info,
+           "votes of " << eliminatedCandidate->getName() << ": " << pile.size()
+                       << " ballots on " << std::max<size_t>(shards, 1) << " threads");
+     if (shards > 1) {
+         transferPile(pile, shards);
+         pile.clear();
+         return;
+     }
+
      // Process all ballots for eliminated candidate
-     for (auto& ballot : candidateBallots[elimID]) {
+     for (auto& ballot : pile) {
          // Process all ballots
          STVBallot* stvBallot = static_cast<STVBallot*>(ballot);
-         stvBallot->removeTopChoice();
 
-         // Add to new candidate if preference is valid
-         int newPref = stvBallot->getPreference();
+         // Skip to the next preference still in the count
+         int newPref = stvBallot->advance(eliminated);
  
-         if (newPref != -1 && !eliminated[newPref]) {
+         if (newPref != -1) {
              candidateBallots[newPref].push_back(ballot);
-             candidates[newPref]->updateVotes(1);
+             addVotes(newPref, ballotValue(stvBallot));
          }
      }
      // Clear ballots for eliminated candidate
-     candidateBallots[elimID].clear();
+     pile.clear();
+ }
+
+// Each shard is a contiguous slice of the pile, sorted into per-recipient
+// buckets by its own thread - only the ballots of the slice are touched and
+// eliminated is only read. Buckets are then appended shard by shard, so every
+// recipient's pile ends up in the order a single pass would give it.
+ void STV::transferPile(const std::vector<Ballot*>& pile, size_t shards) {
+     struct Buckets {
+         std::vector<std::vector<Ballot*>> ballots; // Per recipient, in pile order
+         std::vector<std::int64_t> votes;           // Value moved to each recipient
+     };
+     std::vector<Buckets> buckets(shards);
+
+     parallel::forEach(shards, numThreads, [&](size_t shard) {
+         Buckets& local = buckets[shard];
+         local.ballots.resize(candidates.size());
+         local.votes.assign(candidates.size(), 0);
+         const size_t first = pile.size() * shard / shards;
+         const size_t last = pile.size() * (shard + 1) / shards;
+         for (size_t i = first; i < last; ++i) {
+             STVBallot* stvBallot = static_cast<STVBallot*>(pile[i]);
+             int newPref = stvBallot->advance(eliminated);
+             if (newPref != -1) {
+                 local.ballots[newPref].push_back(pile[i]);
+                 local.votes[newPref] += ballotValue(stvBallot);
+             }
+         }
+     });
+
+     // Merge - one vote update per recipient
+     for (size_t c = 0; c < candidates.size(); ++c) {
+         std::int64_t votes = 0;
+         for (Buckets& local : buckets) {
+             candidateBallots[c].insert(candidateBallots[c].end(),
+                                        local.ballots[c].begin(), local.ballots[c].end());
+             votes += local.votes[c];
+         }
+         if (votes > 0) addVotes(c, votes);
+     }
+ }
+
+// Ballots sharing a ranking prefix share its node, so a ballot is on the
+// trie once per distinct prefix rather than once per ballot
+ void STV::distributeTrie() {
+     preferences.reset(candidates.size());
+     for (auto* ballot : ballots) {
+         STVBallot* stvBallot = static_cast<STVBallot*>(ballot);
+         stvBallot->resetPreference();
+         preferences.add(stvBallot->getRanking(), stvBallot->getWeight());
+     }
+     preferences.finish();
+     candidateNodes.assign(candidates.size(), {});
+     nodeValues.assign(preferences.size(), 0);
+
+     std::vector<std::int64_t> moved(candidates.size(), 0);
+     moveChildren(PreferenceTrie::root, STVBallot::fullValue, moved);
+     for (size_t c = 0; c < candidates.size(); ++c) {
+         if (moved[c] > 0) addVotes(c, moved[c]);
+     }
+ }
+
+// A ballot that leaves its first preference below the quota is neither split
+// nor elects anyone in deliver(), it only joins the pile - those go straight
+// onto the piles with their votes held back, and the held votes are added
+// before any ballot that needs the full deliver(). Piles and votes come out
+// as if every ballot had gone through deliver(), in the same order.
+ bool STV::distributeColumns(std::vector<Candidate*>& elected) {
+     if (!store || store->rankColumns().empty() || ballots.size() != store->size()) {
+         return false;
+     }
+     // Ballots built outside the store (or copies of its views) have no row,
+     // the row path counts them instead
+     if (std::any_of(ballots.begin(), ballots.end(), [&](const Ballot* ballot) {
+             return store->rowOf(ballot) == store->size();
+         })) {
+         return false;
+     }
+     const RankColumns& columns = store->rankColumns();
+     std::vector<std::int64_t> firsts = store->firstPreferenceCounts();
+     for (size_t c = 0; c < candidates.size(); ++c) {
+         candidateBallots[c].reserve(candidateBallots[c].size() + firsts[c]);
+     }
+     TRACE(trace::Transfer, trace::Level::Info,
+           "first preferences of " << ballots.size() << " ballots from rank columns");
+
+     const std::int64_t quota = static_cast<std::int64_t>(droop) * STVBallot::fullValue;
+     std::vector<std::int64_t> held(candidates.size(), 0);
+     std::vector<int> holding; // Candidates with held votes
+     auto release = [&]() {
+         for (int c : holding) {
+             addVotes(c, held[c]);
+             held[c] = 0;
+         }
+         holding.clear();
+     };
+
+     for (auto* ballot : ballots) {
+         size_t row = store->rowOf(ballot);
+         STVBallot* stvBallot = static_cast<STVBallot*>(ballot);
+         stvBallot->resetPreference();
+         int pref = columns.firstPreference(row);
+         if (pref != -1 && eliminated[pref]) pref = stvBallot->skipExcluded(eliminated);
+         if (pref == -1) continue;
+
+         std::int64_t value = ballotValue(stvBallot);
+         if (tally(pref) + held[pref] + value < quota) {
+             if (held[pref] == 0) holding.push_back(pref);
+             held[pref] += value;
+             candidateBallots[pref].push_back(ballot);
+         } else {
+             release();
+             deliver(stvBallot, droop, elected, false);
+         }
+     }
+     release();
+     return true;
+ }
+
+// Same values as moving the ballots one by one - every ballot of a node has
+// the same history, so one value and one rounding per node
+ void STV::transferNodes(int index, std::int64_t transferValue) {
+     std::vector<int> held;
+     held.swap(candidateNodes[index]);
+     TRACE(trace::Transfer, trace::Level::Info,
+           "votes of " << candidates[index]->getName() << ": " << held.size()
+                       << " trie nodes at transfer value " << transferValue << "/"
+                       << STVBallot::fullValue);
+     std::vector<std::int64_t> moved(candidates.size(), 0);
+     for (int node : held) {
+         int value = static_cast<int>(
+             mulDiv(nodeValues[node], transferValue, STVBallot::fullValue));
+         if (value == 0) continue; // rounded away
+         moveChildren(node, value, moved);
+     }
+     for (size_t c = 0; c < candidates.size(); ++c) {
+         if (moved[c] > 0) addVotes(c, moved[c]);
+     }
+ }
+
+ void STV::moveChildren(int node, int value, std::vector<std::int64_t>& moved) {
+     for (int child = preferences.node(node).firstChild; child != -1;
+          child = preferences.node(child).nextSibling) {
+         int candidate = preferences.node(child).candidate;
+         if (eliminated[candidate]) {
+             moveChildren(child, value, moved);
+             continue;
+         }
+         candidateNodes[candidate].push_back(child);
+         nodeValues[child] = value;
+         moved[candidate] += preferences.node(child).count * value;
+     }
  }
  
  
@@ -137,7 +470,14 @@ void STV::setShuffle(bool shuffle) {
  void STV::runElection(std::vector<Candidate*>& winners, std::vector<Candidate*>& losers) {
 
      // Calculate winning threshold - droop quota
-     const int droop = calculateDroop();
+     droop = calculateDroop();
+     fractions.assign(candidates.size(), 0);
+     quotaReached.clear();
+     eliminations.clear();
+     electedList = &winners;
+     splitBallots.clear();
+     splitOrigins.clear();
+     buildHopefuls();
      int ballotOrder = 0;
      std::unordered_map<int, int> firstReceiptOrder;
  
@@ -153,34 +493,34 @@ void STV::setShuffle(bool shuffle) {
          std::shuffle(ballots.begin(), ballots.end(), g);
      }
 
-    //Print ballots AFTER shuffling - for testing
-    
-     std::cout << "After Shuffle:" << std::endl;
-     for (auto* b : ballots) {
-        std::cout << "Ballot ID: " << b->getID() << " -> ";
-        for (int vote : b->getVotes()) std::cout << vote << " ";
-        std::cout << std::endl;
+    // Ballot order after shuffling - one line per ballot, so Debug only
+     if (trace::enabled(trace::Shuffle, trace::Level::Debug)) {
+         for (auto* b : ballots) {
+             std::ostringstream line;
+             line << "ballot " << b->getID() << " ->";
+             for (int vote : b->getVotesView()) line << ' ' << vote;
+             trace::write(trace::Shuffle, line.str());
+         }
      }
  
-     // Initial ballot distribution to first preferences
-     for (auto& ballot : ballots) {
-         STVBallot* stvBallot = static_cast<STVBallot*>(ballot);
-         int pref = stvBallot->getPreference();
+     // Initial ballot distribution to first preferences - ballots start from
+     // their first choice again so the same ballots can be counted twice
+     if (gregory && useTrie) {
+         distributeTrie();
+     } else if (!distributeColumns(winners)) {
+         for (auto& ballot : ballots) {
+             STVBallot* stvBallot = static_cast<STVBallot*>(ballot);
+             stvBallot->resetPreference();
+             int pref = stvBallot->skipExcluded(eliminated);
          
-         if (pref != -1 && !eliminated[pref]) {
-             candidateBallots[pref].push_back(ballot);
-             candidates[pref]->updateVotes(1);
-             
-             // Track first ballot receipt
-             if (firstReceiptOrder[pref] == -1) {
-                 firstReceiptOrder[pref] = ballotOrder++;
-             }
+             if (pref != -1) {
+                 // Track first ballot receipt
+                 if (firstReceiptOrder[pref] == -1) {
+                     firstReceiptOrder[pref] = ballotOrder++;
+                 }
              
-             // Immediate election check
-             if (candidates[pref]->getNumVotes() >= droop) {
-                 winners.push_back(candidates[pref]);
-                 eliminated[pref] = true;
-                 //candidateBallots[pref].clear();
+                 // Add to the candidate, with an immediate election check
+                 deliver(stvBallot, droop, winners, false);
              }
          }
      }
@@ -189,10 +529,7 @@ void STV::setShuffle(bool shuffle) {
      // Main election loop - continues until all seats filled
      while (winners.size() < static_cast<size_t>(getNumSeats())) {
          // Check if remaining candidates <= remaining seats
-         int remaining = 0;
-         for (size_t i = 0; i < candidates.size(); ++i) {
-             if (!eliminated[i] && !candidates[i]->isWinner()) remaining++;
-         }
+         int remaining = hopefuls.size();
          int remainingSeats = getNumSeats() - winners.size();
  
          // If candidates <= seats, elect all remaining
@@ -200,9 +537,12 @@ void STV::setShuffle(bool shuffle) {
              for (size_t i = 0; i < candidates.size(); ++i) {
                  if (!eliminated[i] && !candidates[i]->isWinner()) {
                      winners.push_back(candidates[i]);  // Elect remaining candidates
+                     TRACE(trace::Round, trace::Level::Info,
+                           "elected " << candidates[i]->getName()
+                                      << " as one of the last hopefuls");
                      candidates[i]->setWinner(true);
                      //added
-                     eliminated[i] = true;  // Mark as elected
+                     removeHopeful(i);  // Mark as elected
 
                      // Ensure they're not in losers list
                      losers.erase(std::remove(losers.begin(), losers.end(), candidates[i]), losers.end()); ///added
@@ -211,13 +551,21 @@ void STV::setShuffle(bool shuffle) {
              break;
          }
  
-         // Try to elect candidates who reached quota
+         // Try to elect candidates who reached quota, in candidate order -
+         // only those that reached it since the last round need checking
          bool elected = false;
-         for (size_t i = 0; i < candidates.size(); ++i) {
+         std::vector<int> pending;
+         pending.swap(quotaReached);
+         std::sort(pending.begin(), pending.end());
+         for (int i : pending) {
+             if (winners.size() >= static_cast<size_t>(getNumSeats())) break;
              if (!eliminated[i] && candidates[i]->getNumVotes() >= droop) {
                  winners.push_back(candidates[i]);
-                 eliminated[i] = true;
+                 removeHopeful(i);
                  elected = true;
+                 TRACE(trace::Round, trace::Level::Info,
+                       "elected " << candidates[i]->getName() << " with "
+                                  << candidates[i]->getNumVotes() << " votes, quota " << droop);
                  redistributeSurplus(candidates[i], droop);
              }
          }
@@ -227,29 +575,54 @@ void STV::setShuffle(bool shuffle) {
  
          // If no one is elected, eliminate lowest candidate 
          
-         if (!elected) {
+         std::vector<int> batch;
+         if (!elected && batchElimination) {
+             batch = findHopeless(getNumSeats() - static_cast<int>(winners.size()));
+         }
+         if (batch.size() > 1) {
+             // The whole batch is out before any ballot moves, so each
+             // ballot goes straight past all of them
+             eliminations.emplace_back();
+             for (int i : batch) {
+                 removeHopeful(i);
+                 losers.push_back(candidates[i]);
+                 eliminations.back().push_back(candidates[i]);
+                 TRACE(trace::Round, trace::Level::Info,
+                       "eliminated " << candidates[i]->getName() << " with "
+                                     << candidates[i]->getNumVotes() << " votes, in a batch of "
+                                     << batch.size());
+             }
+             for (int i : batch) redistributeEliminated(candidates[i]);
+         } else if (!elected) {
              Candidate* lowest = findLowestCandidate();
              if (!lowest) break; // Shouldn't happen if seats < candidates
              
              size_t index = lowest->getCandidateID();
-             eliminated[index] = true;
+             removeHopeful(index);
             //  losers.insert(losers.begin(), lowest);
             //  redistributeEliminated(lowest);
              losers.push_back(lowest);  // Changed from insert to push_back
+             eliminations.push_back({lowest});
+             TRACE(trace::Round, trace::Level::Info,
+                   "eliminated " << lowest->getName() << " with "
+                                 << lowest->getNumVotes() << " votes");
              redistributeEliminated(lowest);
          }
 
      }
-    // Debug statements
-    /*
-    std::cout << "\nDEBUG - Final Classification:\n";
-    std::cout << "Winners (" << winners.size() << "):\n";
-    for (auto* w : winners) {
-        std::cout << "  " << w->getName() << ": " << w->getNumVotes() << " votes\n";
-    }
-    std::cout << "Losers (" << losers.size() << "):\n";
-    for (auto* l : losers) {
-        std::cout << "  " << l->getName() << ": " << l->getNumVotes() << " votes\n";
+
+    // Give split parts back to the grouped ballots they came from, latest
+    // split first, so the ballots can be counted again
+    for (size_t i = splitBallots.size(); i-- > 0;) {
+        splitOrigins[i]->setWeight(splitOrigins[i]->getWeight() + splitBallots[i].getWeight());
     }
-    */ 
+    electedList = nullptr;
+
+    // Final classification
+    for (auto* w : winners)
+        TRACE(trace::Round, trace::Level::Info,
+              "winner " << w->getName() << ": " << w->getNumVotes() << " votes");
+    for (auto* l : losers)
+        TRACE(trace::Round, trace::Level::Info,
+              "loser " << l->getName() << ": " << l->getNumVotes() << " votes");
 }
@@ -7,8 +7,14 @@
 #define STV_H
 
 #include "Election.h"
+#include "indexedheap.h"
+#include "preferencetrie.h"
 #include "stvballot.h"
+#include <climits>
+#include <cstdint>
+#include <deque>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 /*
  * IMPORTANT NOTE: Uncomment FRIEND_TESTs and the include below to run stv_UT,
@@ -34,6 +40,22 @@ private:
   std::vector<std::vector<Ballot *>> candidateBallots; // Ballots per candidate
   std::unordered_map<int, int>
       candidateFirstReceiptOrder; // Track first ballot receipt
+  IndexedMinHeap<std::pair<std::int64_t, int>> hopefuls; // Hopeful candidates keyed by (tally, index)
+  bool hopefulsReady = false;   // hopefuls built from the current votes
+  std::vector<int> quotaReached; // Hopefuls that reached the quota since the last round
+  int droop = INT_MAX;          // Quota of the running election
+  std::deque<STVBallot> splitBallots; // Parts split off grouped ballots
+  std::vector<STVBallot *> splitOrigins; // Ballot each part was split from
+  bool gregory = false;         // Surplus moves every ballot at a fraction of its value
+  std::vector<std::int64_t> fractions; // Part of a vote held beyond getNumVotes(), 1/STVBallot::fullValue units
+  bool useTrie = false;         // Gregory transfers move preference-trie nodes instead of ballots
+  PreferenceTrie preferences;   // Ballots merged by preference prefix, trie counts only
+  std::vector<std::vector<int>> candidateNodes; // Trie nodes each candidate holds the ballots of
+  std::vector<int> nodeValues;  // Value of each ballot at a held node
+  bool batchElimination = false; // Eliminate every hopeless candidate of a round together
+  std::vector<std::vector<Candidate *>> eliminations; // Candidates eliminated in each round
+  std::vector<Candidate *> *electedList = nullptr; // Winners list of the running count
+  const BallotStore *store = nullptr; // Store behind ballots, for its rank columns
 
 public:
   // Constructor
@@ -50,6 +72,63 @@ public:
    */
   void setShuffle(bool shuffle);
 
+  /**
+   * @brief turns Gregory (weighted inclusive) surplus transfers on or off
+   * When on, an elected candidate's surplus is moved by passing every one
+   * of its ballots on at the transfer value surplus / votes, in fixed-point
+   * so results are reproducible, instead of moving the first ballots of its
+   * pile whole. The result then no longer depends on ballot order there.
+   * @param gregory true for fractional transfers
+   */
+  void setGregory(bool gregory);
+
+  /**
+   * @brief counts Gregory elections on a preference trie instead of piles
+   * Ballots with the same first preferences share a trie node, and a
+   * candidate holds nodes rather than ballots, so surplus and elimination
+   * transfers cost one step per distinct prefix. Only used with
+   * setGregory(true) - whole-ballot transfers move the first ballots of a
+   * pile and need the piles. First preferences are all counted before
+   * anyone is elected, so a candidate above the quota on first preferences
+   * passes its surplus on fractionally like any other winner.
+   * @param trie true to count on the trie
+   */
+  void setPreferenceTrie(bool trie);
+
+  /**
+   * @brief turns batch elimination of hopeless candidates on or off
+   * When on and nobody reaches the quota, the lowest candidates are
+   * eliminated together as long as their votes added up stay below the
+   * next candidate's - even with all their ballots they could not overtake
+   * anyone, so one at a time they would go in the same order. Their ballots
+   * are transferred in one pass, skipping the whole batch, and at least as
+   * many candidates as seats left stay in the count.
+   * @param batch true to eliminate in batches
+   */
+  void setBatchElimination(bool batch);
+
+  /**
+   * @brief lets the first-preference distribution read the store's rank columns
+   * The ballots must be the store's STV views, in any order, and the store
+   * built with rank columns (Election::setRankColumns). The initial
+   * distribution then takes each ballot's first preference from the
+   * first-preference column instead of its ranking, sizes the piles from
+   * the weighted first preferences up front, and holds back the votes of
+   * ballots that cannot take their candidate to the quota, so the heap is
+   * updated once per candidate rather than once per ballot. Results are
+   * the same as without the columns.
+   * @param store ballot store the ballots were made from, null to stop
+   */
+  void setBallotStore(const BallotStore *store);
+
+  /**
+   * @brief returns the candidates eliminated in each round of the last count
+   * @return one list per elimination round, lowest votes first
+   */
+  const std::vector<std::vector<Candidate *>> &getEliminations() const {
+    return eliminations;
+  }
+
   // Main election runner
   /**
    * @brief runs the election
@@ -76,6 +155,12 @@ private:
    * @param droop is the droop quota
    */
   void redistributeSurplus(Candidate *winner, int droop);
+  /**
+   * @brief Gregory version of redistributeSurplus
+   * @param winner is the winning candidate
+   * @param droop is the droop quota
+   */
+  void redistributeSurplusGregory(Candidate *winner, int droop);
 
   // IMPORTANT: Uncomment for testing
   //FRIEND_TEST(STVTests, redistributeSurplusTest);
@@ -85,7 +170,20 @@ private:
    * @brief finds candidate with fewest votes
    * @return candidate object with fewest votes
    */
-  Candidate *findLowestCandidate() const;
+  Candidate *findLowestCandidate();
+  /**
+   * @brief finds the lowest candidates that can be eliminated together
+   * @param remainingSeats seats not filled yet
+   * @return candidate indices, lowest first - fewer than two when no
+   *         batch is safe
+   */
+  std::vector<int> findHopeless(int remainingSeats) const;
+  /**
+   * @brief returns the surplus that has not been transferred yet
+   * @return votes above the quota held by hopefuls waiting to be elected,
+   *         in 1/STVBallot::fullValue units
+   */
+  std::int64_t pendingSurplus() const;
   // IMPORTANT: Uncomment for testing
   //FRIEND_TEST(STVTests, FindLowestCandidateTest);
 
@@ -95,6 +193,83 @@ private:
    * @param eliminatedCandidate is eliminated candidate object
    */
   void redistributeEliminated(Candidate *eliminatedCandidate);
+  /**
+   * @brief moves an eliminated candidate's ballots to their next preferences on several threads
+   * Used by redistributeEliminated for piles of at least shards times the
+   * tally threshold (see setTallyThreshold, setNumThreads). Recipient piles
+   * get the ballots in the same order as the single-threaded transfer.
+   * @param pile ballots of the eliminated candidate
+   * @param shards number of slices the pile is cut into
+   */
+  void transferPile(const std::vector<Ballot *> &pile, size_t shards);
+  /**
+   * @brief merges the ballots into preferences and hands out first preferences
+   */
+  void distributeTrie();
+  /**
+   * @brief hands out first preferences read from the rank columns of the store
+   * @param elected list a candidate reaching the quota is added to
+   * @return false, with nothing handed out, when there are no columns to
+   *         read or a ballot is not a view of the store
+   */
+  bool distributeColumns(std::vector<Candidate *> &elected);
+  /**
+   * @brief moves every node a candidate holds on to the next preferences
+   * @param index candidate giving up its nodes
+   * @param transferValue share of their value the ballots keep, in
+   *                      1/STVBallot::fullValue units
+   */
+  void transferNodes(int index, std::int64_t transferValue);
+  /**
+   * @brief hands the children of a node to their candidates
+   * Children naming a candidate out of the count are passed through to
+   * their own children.
+   * @param node trie node whose ballots move on
+   * @param value value of each ballot
+   * @param moved votes given to each candidate, added to
+   */
+  void moveChildren(int node, int value, std::vector<std::int64_t> &moved);
+
+  /**
+   * @brief puts every candidate still in the count into hopefuls
+   */
+  void buildHopefuls();
+  /**
+   * @brief returns a candidate's votes including the fraction of a vote
+   * @param index position of the candidate
+   * @return votes in 1/STVBallot::fullValue units
+   */
+  std::int64_t tally(int index) const;
+  /**
+   * @brief gives a candidate votes and keeps hopefuls in order
+   * Whole votes go to the candidate, the rest is kept in fractions.
+   * @param index position of the candidate
+   * @param value votes in 1/STVBallot::fullValue units
+   */
+  void addVotes(int index, std::int64_t value);
+  /**
+   * @brief takes a candidate out of the count (elected or eliminated)
+   * @param index position of the candidate
+   */
+  void removeHopeful(int index);
+  /**
+   * @brief hands a ballot to its preference, electing a candidate that reaches the quota
+   * When only part of a grouped ballot fits under the quota, the rest is
+   * split off and moves on down its ranking, as single ballots would.
+   * @param ballot ballot to hand out
+   * @param droop is the droop quota
+   * @param elected list a candidate reaching the quota is added to
+   * @param clearPile true to drop the ballots of a candidate elected here
+   */
+  void deliver(STVBallot *ballot, int droop, std::vector<Candidate *> &elected,
+               bool clearPile);
+  /**
+   * @brief splits part of a grouped ballot off into a ballot of its own
+   * @param ballot grouped ballot, keeps the rest of its weight
+   * @param weight weight of the new ballot
+   * @return the new ballot, at the same preference
+   */
+  STVBallot *splitBallot(STVBallot *ballot, int weight);
 
 };
 
@@ -1,8 +1,8 @@
 /*
 * File: Election_UT.cc
 * Description: Includes all unit tests for STV election logic (stv.cpp)
-* Tests: Constructor tests, droop quota calculation, ballot shuffling, single candidate case, 
-*        candidate elimination, vote redistribution, edge cases
+* Tests: Constructor tests, droop quota calculation, ballot shuffling, single candidate case, grouped ballots,
+*        candidate elimination, vote redistribution, preference trie, edge cases
 * Author: Zoe Sepersky, Anwesha Samaddar
 */
 
@@ -214,7 +214,7 @@ TEST_F(STVTests, FindLowestCandidateTest) {
 // Tests single candidate election case
 TEST_F(STVTests, SingleCandidateTest) {
 
-  Ballot* ballot = new Ballot({1}, 1);
+  Ballot* ballot = new STVBallot({1}, 1);
   Candidate* solo = new Candidate("D");
   single_candidate = {solo};
   ballots_single_candidate = {ballot};
@@ -300,7 +300,268 @@ TEST_F(STVTests, runElectionTest) {
 }
 
 
+// Tests a grouped ballot that takes its candidate past the quota - only the
+// votes needed are given, the rest moves on like single ballots would
+TEST_F(STVTests, GroupedBallotTest) {
+  STVBallot *group = new STVBallot({1,2,0}, 1);  // A(1), B(2)
+  group->setWeight(4);
+  STVBallot *single = new STVBallot({0,2,1}, 5); // C(1), B(2)
+  std::vector<Ballot*> grouped_ballots = {group, single};
+
+  STV test(grouped_ballots, candidates, seats); // 5 ballots, quota = 2
+  test.setShuffle(false);
+
+  std::vector<Candidate*> winners;
+  std::vector<Candidate*> losers;
+  test.runElection(winners, losers);
+
+  ASSERT_EQ(winners.size(), 2);
+  EXPECT_EQ(winners[0]->getName(), "A");
+  EXPECT_EQ(winners[0]->getNumVotes(), 2);
+  EXPECT_EQ(winners[1]->getName(), "B");
+  EXPECT_EQ(winners[1]->getNumVotes(), 2);
+  EXPECT_EQ(candidates[2]->getNumVotes(), 1);
+
+  // The split parts are merged back after the count
+  EXPECT_EQ(group->getWeight(), 4);
+
+  for (auto* b : grouped_ballots) delete b;
+}
+
+// Gregory transfers pass on a share of every ballot instead of the first
+// ballots of the pile, whatever order the ballots are counted in
+TEST_F(STVTests, GregoryTransferTest) {
+  auto run = [](bool gregory, bool shuffle) {
+    std::vector<Candidate*> cands = {new Candidate("A", 0), new Candidate("B", 1),
+                                     new Candidate("C", 2), new Candidate("D", 3)};
+    std::vector<Ballot*> ranked = {
+      new STVBallot({1,0,2,0}, 1),  // A > C
+      new STVBallot({1,0,0,2}, 2),  // A > D
+      new STVBallot({1,0,0,2}, 3),  // A > D
+      new STVBallot({2,1,0,0}, 4),  // B > A
+      new STVBallot({2,1,0,0}, 5),  // B > A
+      new STVBallot({0,2,1,0}, 6),  // C > B
+      new STVBallot({0,2,1,0}, 7),  // C > B
+      new STVBallot({0,2,0,1}, 8),  // D > B
+      new STVBallot({0,2,0,1}, 9)   // D > B
+    };
+    // 9 ballots, 2 seats, quota = 4 - B goes first and A gets 5 votes
+    STV test(ranked, cands, 2);
+    test.setShuffle(shuffle);
+    test.setGregory(gregory);
+    std::vector<Candidate*> winners, losers;
+    testing::internal::CaptureStdout();
+    test.runElection(winners, losers);
+    testing::internal::GetCapturedStdout();
+
+    std::vector<std::string> result;
+    for (auto* c : winners) result.push_back(c->getName() + " " + std::to_string(c->getNumVotes()));
+    for (auto* c : losers) result.push_back(c->getName() + " " + std::to_string(c->getNumVotes()));
+    for (auto* b : ranked) delete b;
+    for (auto* c : cands) delete c;
+    return result;
+  };
+
+  // Whole ballots - the A > C ballot is first in A's pile and moves
+  EXPECT_EQ(run(false, false), (std::vector<std::string>{"A 5", "C 3", "B 2", "D 2"}));
+
+  // Gregory - each ballot moves at 1/5, C gets 0.2 and D 0.4, so C goes
+  std::vector<std::string> expected = {"A 5", "D 2", "B 2", "C 2"};
+  EXPECT_EQ(run(true, false), expected);
+  for (int i = 0; i < 5; i++)
+    EXPECT_EQ(run(true, true), expected);
+}
+
+// Gregory counts on the preference trie give the pile results, grouped or not
+TEST_F(STVTests, PreferenceTrieTest) {
+  auto run = [](const std::string& file, bool trie, bool grouping) {
+    Election election({file}, "STV", 2);
+    election.setGroupBallots(grouping);
+    election.setBallots();
+    STV stv(election.getBallots(), election.getCandidates(), 2);
+    stv.setShuffle(false);
+    stv.setGregory(true);
+    stv.setPreferenceTrie(trie);
+    std::vector<Candidate*> winners, losers;
+    testing::internal::CaptureStdout();
+    stv.runElection(winners, losers);
+    testing::internal::GetCapturedStdout();
+
+    std::vector<std::pair<std::string, int>> result;
+    for (auto* c : winners) result.push_back({"W " + c->getName(), c->getNumVotes()});
+    for (auto* c : losers) result.push_back({"L " + c->getName(), c->getNumVotes()});
+    return result;
+  };
+
+  for (const char* file : {"../../testing/stv_mixed_ballots_300.csv",
+                           "../../testing/stv_all_inputs_mixed.csv"}) {
+    auto expected = run(file, false, false);
+    EXPECT_EQ(run(file, true, false), expected);
+    EXPECT_EQ(run(file, true, true), expected);
+  }
+
+  // Bill Jones has 8 first preferences against a quota of 4 - the trie counts
+  // them all and passes the surplus on instead of electing at the 4th ballot
+  auto trie = run("../../testing/stv_ballots.csv", true, false);
+  ASSERT_EQ(trie.size(), 5u);
+  EXPECT_EQ(trie[0], (std::pair<std::string, int>{"W Bill Jones", 8}));
+  EXPECT_EQ(trie[1], (std::pair<std::string, int>{"W Sally Ride", 4}));
+}
+
+// A candidate that a surplus transfer takes past the quota is one of the winners
+TEST_F(STVTests, SurplusElectsTest) {
+  std::vector<Candidate*> cands = {new Candidate("A", 0), new Candidate("B", 1),
+                                   new Candidate("C", 2), new Candidate("D", 3)};
+  std::vector<Ballot*> ranked;
+  auto add = [&](int copies, std::vector<int> votes) {
+    for (int i = 0; i < copies; i++)
+      ranked.push_back(new STVBallot(votes, static_cast<int>(ranked.size()) + 1));
+  };
+  add(3, {1, 2, 0, 0}); // A > B
+  add(3, {0, 1, 2, 0}); // B > C
+  add(2, {2, 3, 1, 0}); // C > A > B
+  add(2, {0, 0, 2, 1}); // D > C
+  // Quota 4 - C goes, A gets 5 and its surplus ballot takes B to 4. B used
+  // to be elected into Election::winners, not the caller's list, so it was
+  // left out and D took the second seat
+  STV stv(ranked, cands, 2);
+  stv.setShuffle(false);
+  std::vector<Candidate*> winners, losers;
+  testing::internal::CaptureStdout();
+  stv.runElection(winners, losers);
+  testing::internal::GetCapturedStdout();
+
+  ASSERT_EQ(winners.size(), 2u);
+  EXPECT_EQ(winners[0]->getName(), "A");
+  EXPECT_EQ(winners[1]->getName(), "B");
+  for (auto* b : ranked) delete b;
+  for (auto* c : cands) delete c;
+}
+
+// F and E go out together, C and D can still catch up and go one at a time
+TEST_F(STVTests, BatchEliminationTest) {
+  auto run = [](bool batch) {
+    std::vector<Candidate*> cands;
+    for (const char* name : {"A", "B", "C", "D", "E", "F"})
+      cands.push_back(new Candidate(name, static_cast<int>(cands.size())));
+    std::vector<Ballot*> ranked;
+    auto add = [&](int copies, std::vector<int> votes) {
+      for (int i = 0; i < copies; i++)
+        ranked.push_back(new STVBallot(votes, static_cast<int>(ranked.size()) + 1));
+    };
+    add(5, {1, 2, 3, 0, 0, 0}); // A > B > C
+    add(4, {2, 1, 3, 0, 0, 0}); // B > A > C
+    add(3, {3, 2, 1, 0, 0, 0}); // C > B > A
+    add(2, {0, 3, 2, 1, 0, 0}); // D > C > B
+    add(1, {0, 0, 3, 2, 1, 0}); // E > D > C
+
+    STV stv(ranked, cands, 1);
+    stv.setShuffle(false);
+    stv.setBatchElimination(batch);
+    std::vector<Candidate*> winners, losers;
+    testing::internal::CaptureStdout();
+    stv.runElection(winners, losers);
+    testing::internal::GetCapturedStdout();
+
+    std::vector<std::string> result;
+    for (auto* c : winners) result.push_back(c->getName() + " " + std::to_string(c->getNumVotes()));
+    for (const auto& round : stv.getEliminations()) {
+      std::string names;
+      for (auto* c : round) names += c->getName();
+      result.push_back(names);
+    }
+    for (auto* b : ranked) delete b;
+    for (auto* c : cands) delete c;
+    return result;
+  };
+
+  EXPECT_EQ(run(false), (std::vector<std::string>{"B 9", "F", "E", "C", "D"}));
+  EXPECT_EQ(run(true), (std::vector<std::string>{"B 9", "FE", "C", "D"}));
+}
+
+// First preferences read from rank columns give the same count, including
+// stv_ballots.csv where Bill Jones reaches the quota during the distribution
+TEST_F(STVTests, RankColumnsTest) {
+  auto run = [](const std::string& file, bool columnar, bool grouping) {
+    Election election({file}, "STV", 2);
+    election.setGroupBallots(grouping);
+    election.setRankColumns(columnar);
+    election.setBallots();
+    STV stv(election.getBallots(), election.getCandidates(), 2);
+    stv.setShuffle(false);
+    stv.setBallotStore(&election.getBallotStore());
+    std::vector<Candidate*> winners, losers;
+    testing::internal::CaptureStdout();
+    stv.runElection(winners, losers);
+    testing::internal::GetCapturedStdout();
+
+    std::vector<std::pair<std::string, int>> result;
+    for (auto* c : winners) result.push_back({"W " + c->getName(), c->getNumVotes()});
+    for (auto* c : losers) result.push_back({"L " + c->getName(), c->getNumVotes()});
+    return result;
+  };
+
+  for (const char* file : {"../../testing/stv_mixed_ballots_300.csv",
+                           "../../testing/stv_all_inputs_mixed.csv",
+                           "../../testing/stv_ballots.csv"}) {
+    for (bool grouping : {false, true}) {
+      auto expected = run(file, false, grouping);
+      EXPECT_EQ(run(file, true, grouping), expected);
+    }
+  }
+
+  // Ballots that are not views of the store are counted on the row path
+  Election election({"../../testing/stv_ballots.csv"}, "STV", 2);
+  election.setRankColumns(true);
+  election.setBallots();
+  ASSERT_FALSE(election.getBallotStore().rankColumns().empty());
+  std::vector<Ballot*> owned;
+  for (auto* b : election.getBallots())
+    owned.push_back(new STVBallot(b->getVotes(), b->getID()));
+  STV stv(owned, election.getCandidates(), 2);
+  stv.setShuffle(false);
+  stv.setBallotStore(&election.getBallotStore());
+  std::vector<Candidate*> winners, losers;
+  testing::internal::CaptureStdout();
+  EXPECT_NO_THROW(stv.runElection(winners, losers));
+  testing::internal::GetCapturedStdout();
+  std::vector<std::pair<std::string, int>> result;
+  for (auto* c : winners) result.push_back({"W " + c->getName(), c->getNumVotes()});
+  for (auto* c : losers) result.push_back({"L " + c->getName(), c->getNumVotes()});
+  EXPECT_EQ(result, run("../../testing/stv_ballots.csv", false, false));
+  for (auto* b : owned) delete b;
+}
+
+// Piles transferred on several threads give the single-threaded result
+TEST_F(STVTests, ParallelTransferTest) {
+  auto run = [](int threads, bool grouping) {
+    Election election({"../../testing/stv_mixed_ballots_300.csv"}, "STV", 2);
+    election.setGroupBallots(grouping);
+    election.setBallots();
+    STV stv(election.getBallots(), election.getCandidates(), 2);
+    stv.setShuffle(false);
+    stv.setNumThreads(threads);
+    stv.setTallyThreshold(1); // every pile of 2+ ballots is split
+    std::vector<Candidate*> winners, losers;
+    testing::internal::CaptureStdout();
+    stv.runElection(winners, losers);
+    testing::internal::GetCapturedStdout();
+
+    std::vector<std::pair<std::string, int>> result;
+    for (auto* c : winners) result.push_back({"W " + c->getName(), c->getNumVotes()});
+    for (auto* c : losers) result.push_back({"L " + c->getName(), c->getNumVotes()});
+    return result;
+  };
+
+  for (bool grouping : {false, true}) {
+    auto expected = run(1, grouping);
+    EXPECT_EQ(run(3, grouping), expected);
+    EXPECT_EQ(run(8, grouping), expected);
+  }
+}
+
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -7,64 +7,172 @@
  */
 
 #include "stvballot.h"
-#include <climits>
+#include "ballotstatus.h"
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 
+static_assert(sizeof(STVBallot) == 64,
+              "an STV ballot with an inline ranking is one cache line");
+
+namespace {
+
+// Insertion sort of the ranked candidates by rank - equal ranks keep column
+// order, the order the old rescan picked them in
+template <typename T>
+int sortRanking(const int *votes, int numVotes, T *ranking) {
+    int numRanked = 0;
+    for (int i = 0; i < numVotes; i++) {
+        if (votes[i] <= 0) continue;
+        int j = numRanked++;
+        while (j > 0 && votes[ranking[j - 1]] > votes[i]) {
+            ranking[j] = ranking[j - 1];
+            j--;
+        }
+        ranking[j] = static_cast<T>(i);
+    }
+    return numRanked;
+}
+
+// Moves the cursor past excluded candidates, one loop per ranking storage
+template <typename T>
+int skip(const T *ranking, int numRanked, int cursor,
+         const std::vector<bool> &excluded) {
+    while (cursor < numRanked && excluded[ranking[cursor]]) {
+        cursor++;
+    }
+    return cursor;
+}
+
+} // namespace
+
 // Constructor - validates ballot and sets initial preference
 STVBallot::STVBallot(std::vector<int> votes, int id)
-    : Ballot(votes, id), preference(-1) {
-    // Count of ranked candidates
-    int rankedCount = 0;
+    : Ballot(votes, id), numRanked(0), cursor(0), value(fullValue) {
+    if (!isInline()) spilled = {nullptr, false};
+    validate();
+    initialize();
+}
+
+// Constructor for a BallotStore row - already validated by the loader
+STVBallot::STVBallot(int *votes, int numVotes, int id, int *ranking)
+    : Ballot(votes, numVotes, id), numRanked(0), cursor(0), value(fullValue) {
+    if (!isInline()) spilled = {ranking, false};
+    initialize();
+}
+
+// Copies share a given ranking buffer but duplicate an owned one
+STVBallot::STVBallot(const STVBallot &other)
+    : Ballot(other), numRanked(other.numRanked), cursor(other.cursor),
+      value(other.value) {
+    if (isInline()) {
+        std::copy(other.inlineRanking, other.inlineRanking + inlineRanks,
+                  inlineRanking);
+    } else if (other.spilled.owned) {
+        spilled = {new int[numVotes], true};
+        std::copy(other.spilled.ranking, other.spilled.ranking + numRanked,
+                  spilled.ranking);
+    } else {
+        spilled = other.spilled;
+    }
+}
+
+STVBallot &STVBallot::operator=(const STVBallot &other) {
+    if (this != &other) {
+        STVBallot copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
 
-    // Count non-zero votes
-    for (int vote : votes) {
-        if (vote > 0) rankedCount++;
+// An owned ranking changes hands, an inline one is copied
+STVBallot::STVBallot(STVBallot &&other) noexcept
+    : Ballot(std::move(other)), numRanked(other.numRanked),
+      cursor(other.cursor), value(other.value) {
+    takeRanking(other);
+}
+
+STVBallot &STVBallot::operator=(STVBallot &&other) noexcept {
+    if (this != &other) {
+        releaseRanking();
+        Ballot::operator=(std::move(other));
+        numRanked = other.numRanked;
+        cursor = other.cursor;
+        value = other.value;
+        takeRanking(other);
     }
-    
-    // Require at least half (floor division) of candidates to be ranked
-    int minRequired = votes.size() / 2;
-
-    // Validate minimum ranking requirement
-    if (rankedCount < minRequired) {
-        throw std::invalid_argument(
-            "\nInvalid STV Ballot "+std::to_string(id)+": Only " + std::to_string(rankedCount) + 
-            " candidates ranked (minimum " + std::to_string(minRequired) + " required)."
-        );
+    return *this;
+}
+
+STVBallot::~STVBallot() { releaseRanking(); }
+
+void STVBallot::takeRanking(STVBallot &other) {
+    if (isInline()) {
+        std::copy(other.inlineRanking, other.inlineRanking + inlineRanks,
+                  inlineRanking);
+    } else {
+        spilled = other.spilled;
+        other.spilled.owned = false;
     }
-    // Set initial top preference
-    updatePreference();
+}
+
+void STVBallot::releaseRanking() {
+    if (!isInline() && spilled.owned) {
+        delete[] spilled.ranking;
+        spilled.owned = false;
+    }
+}
+
+// Validates minimum ranking requirement
+void STVBallot::validate() const {
+    BallotStatus status = validateSTV(votes, numVotes);
+    if (status != BallotStatus::Valid) {
+        throw std::invalid_argument(ballotStatusMessage(status, ballotID, votes, numVotes));
+    }
+}
+
+// Builds the ranking order
+void STVBallot::initialize() {
+    if (isInline()) {
+        numRanked = sortRanking(votes, numVotes, inlineRanking);
+    } else {
+        if (!spilled.ranking) spilled = {new int[numVotes], true};
+        numRanked = sortRanking(votes, numVotes, spilled.ranking);
+    }
+    cursor = 0;
 }
 
 
 
 // Removes current top choice and updates preference
 void STVBallot::removeTopChoice() {
-    if (preference != -1) {
-        votes[preference] = 0;
-        updatePreference();
+    if (cursor < numRanked) {
+        cursor++;
     }
 }
 
-// Updates current top preference based on vote rankings
-void STVBallot::updatePreference() {
-    // Reset to invalid vote
-    preference = -1;  
+// Moves past the current choice and every excluded one after it
+int STVBallot::advance(const std::vector<bool> &excluded) {
+    removeTopChoice();
+    return skipExcluded(excluded);
+}
 
-    // Initialize to maximum possible rank
-    int minRank = INT_MAX;   
+// Moves past excluded choices - each is skipped once, so all the transfers
+// of a ballot cost O(candidates) in total
+int STVBallot::skipExcluded(const std::vector<bool> &excluded) {
+    cursor = isInline() ? skip(inlineRanking, numRanked, cursor, excluded)
+                        : skip(spilled.ranking, numRanked, cursor, excluded);
+    return getPreference();
+}
 
-    for (std::size_t i = 0; i < votes.size(); ++i) {
-        // Find candidate with lowest rank
-        if (votes[i] > 0 && votes[i] < minRank) {
-            minRank = votes[i];
-            // Update preferred candidate index
-            preference = i;     
-        }
-    }
+// Back to the first choice at full value
+void STVBallot::resetPreference() {
+    cursor = 0;
+    value = fullValue;
 }
 
 // Returns current top preference candidate index
 int STVBallot::getPreference() const {
-    return preference;
-}
\ No newline at end of file
+    if (cursor >= numRanked) return -1;
+    return isInline() ? inlineRanking[cursor] : spilled.ranking[cursor];
+}
@@ -9,24 +9,147 @@
 #define STVBALLOT_H
 
 #include "ballot.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
 
 /**
  * @class STVBallot
  * @brief represents a STV ballot in an election
+ * The ranked candidates are kept as a list of candidate indices in preference
+ * order, built once when the ballot is created. The current preference is a
+ * cursor into that list, so moving to the next choice never rescans the votes
+ * and the votes themselves are never changed.
+ * Up to inlineRanks candidates the list is stored inside the ballot as
+ * bytes, so a ballot is one cache line and following its preferences reads
+ * nothing else; larger contests spill it to an int buffer.
  */
 
-class STVBallot : public Ballot {
+class alignas(64) STVBallot : public Ballot {
+public:
+    /**
+     * @brief most candidates whose ranking is kept inside the ballot
+     */
+    static constexpr int inlineRanks = 16;
+
 private:
-    int preference;
+    // Ranking of a contest with more than inlineRanks candidates
+    struct Spilled {
+        int *ranking; // A given buffer, or allocated when owned
+        bool owned;
+    };
+
+    // Ordered to fill a cache line after the Ballot members
+    int numRanked;   // Number of ranked candidates
+    union {
+        std::uint8_t inlineRanking[inlineRanks]; // Up to inlineRanks candidates
+        Spilled spilled;                         // More than that
+    };
+    int cursor;      // Position of the current preference in the ranking
+    int value;       // Share of a vote each copy carries, fullValue = 1 vote
+
+    /**
+     * @brief throws invalid_argument unless the minimum ranking rule holds
+     */
+    void validate() const;
+    /**
+     * @brief builds the ranking order
+     */
+    void initialize();
+    /**
+     * @brief true when the ranking is stored inside the ballot
+     */
+    bool isInline() const { return numVotes <= inlineRanks; }
+    /**
+     * @brief frees a spilled ranking this ballot allocated
+     */
+    void releaseRanking();
+    /**
+     * @brief takes the ranking of a ballot being moved from
+     */
+    void takeRanking(STVBallot &other);
 
 public:
     /**
-     * @brief STVBallot constructor
+     * @brief read-only view of a ranking, either storage
+     */
+    class Ranking {
+    public:
+        /**
+         * @brief forward iterator over the candidate indices
+         */
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = int;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const int *;
+            using reference = int;
+
+            iterator() = default;
+            iterator(const std::uint8_t *bytes, const int *ints, int position)
+                : bytes(bytes), ints(ints), position(position) {}
+            int operator*() const { return bytes ? bytes[position] : ints[position]; }
+            iterator &operator++() { ++position; return *this; }
+            iterator operator++(int) { iterator before = *this; ++position; return before; }
+            bool operator==(const iterator &other) const { return position == other.position; }
+
+        private:
+            const std::uint8_t *bytes = nullptr;
+            const int *ints = nullptr;
+            int position = 0;
+        };
+
+        Ranking(const std::uint8_t *bytes, const int *ints, int count)
+            : bytes(bytes), ints(ints), count(count) {}
+        int operator[](int position) const {
+            return bytes ? bytes[position] : ints[position];
+        }
+        std::size_t size() const { return static_cast<std::size_t>(count); }
+        bool empty() const { return count == 0; }
+        iterator begin() const { return {bytes, ints, 0}; }
+        iterator end() const { return {bytes, ints, count}; }
+
+    private:
+        const std::uint8_t *bytes; // Inline ranking, null when spilled
+        const int *ints;           // Spilled ranking
+        int count;
+    };
+
+    /**
+     * @brief value of a ballot that has not been transferred at a fraction
+     * Values are fixed-point with six decimal places, so fractional
+     * transfers round the same way on every run.
+     */
+    static constexpr int fullValue = 1000000;
+
+    /**
+     * @brief STVBallot constructor, throws invalid_argument for an invalid ballot
      */
     STVBallot(std::vector<int> votes, int ballotID);
+    /**
+     * @brief STVBallot constructor for a row of a BallotStore
+     * The store only holds rows that passed validateSTV(), so the row is
+     * not checked again.
+     * @param votes first vote of the row
+     * @param numVotes number of votes in the row
+     * @param ballotID unique ID for the ballot
+     * @param ranking numVotes ints to hold the ranking order of a contest
+     *                with more than inlineRanks candidates, the ballot
+     *                allocates its own when null; not used below that
+     */
+    STVBallot(int *votes, int numVotes, int ballotID, int *ranking = nullptr);
+
+    STVBallot(const STVBallot &other);
+    STVBallot &operator=(const STVBallot &other);
+    STVBallot(STVBallot &&other) noexcept;
+    STVBallot &operator=(STVBallot &&other) noexcept;
+    ~STVBallot();
+
     /** 
      * @brief gets preference of voter 
-     * @return int index of #1 ranking on ballot 
+     * @return int index of #1 ranking on ballot, -1 once the ballot is exhausted
      */
     int getPreference() const;
     /**
@@ -34,9 +157,42 @@ public:
      */
     void removeTopChoice();
     /**
-     * @brief updates current top preference based on vote rankings 
+     * @brief moves the preference to the next ranked candidate still in the count
+     * Candidates marked in excluded (eliminated or elected) are skipped.
+     * @param excluded one flag per candidate, true if it can no longer receive votes
+     * @return the new preference, -1 if the ballot is exhausted
+     */
+    int advance(const std::vector<bool> &excluded);
+    /**
+     * @brief skips the current preference and any later ones that are excluded
+     * Leaves the preference alone if it can still receive the ballot.
+     * @param excluded one flag per candidate, true if it can no longer receive votes
+     * @return the current preference, -1 if the ballot is exhausted
+     */
+    int skipExcluded(const std::vector<bool> &excluded);
+    /**
+     * @brief returns the ranked candidates, most preferred first
+     * @return candidate indices, unaffected by the current preference
+     */
+    Ranking getRanking() const {
+        return isInline() ? Ranking(inlineRanking, nullptr, numRanked)
+                          : Ranking(nullptr, spilled.ranking, numRanked);
+    }
+    /**
+     * @brief returns the share of a vote each copy of the ballot carries
+     * @return value in units of 1/fullValue of a vote
+     */
+    int getValue() const { return value; }
+    /**
+     * @brief sets the share of a vote each copy of the ballot carries
+     * @param value value in units of 1/fullValue of a vote
+     */
+    void setValue(int value) { this->value = value; }
+    /**
+     * @brief moves the preference back to the first choice and restores the
+     * full value so the election can be re-run
      */
-    void updatePreference();
+    void resetPreference();
 };
 
 #endif // STVBALLOT_H
@@ -65,6 +65,100 @@ TEST_F(STVBallotTest, GetPreferenceTest) {
   EXPECT_EQ(test_ballot.getPreference(), preference);
 }
 
+// Test for moving through the ranking - excluded candidates are skipped,
+// the votes are left alone and the ballot can start over
+TEST_F(STVBallotTest, AdvanceTest) {
+  votes = {3, 0, 1, 2, 4, 0};
+  STVBallot test_ballot(votes, ballotID);
+  std::vector<bool> excluded(votes.size(), false);
+  EXPECT_EQ(test_ballot.getPreference(), 2);
+
+  excluded[2] = true;
+  excluded[3] = true;
+  EXPECT_EQ(test_ballot.advance(excluded), 0);
+  test_ballot.removeTopChoice();
+  EXPECT_EQ(test_ballot.getPreference(), 4);
+  EXPECT_EQ(test_ballot.advance(excluded), -1);
+  EXPECT_EQ(test_ballot.getVotes(), votes);
+
+  test_ballot.resetPreference();
+  EXPECT_EQ(test_ballot.getPreference(), 2);
+  EXPECT_EQ(test_ballot.skipExcluded(excluded), 0);
+}
+
+// Fractional values are copied with the ballot and restored on reset
+TEST_F(STVBallotTest, ValueTest) {
+  votes = {1, 2, 0};
+  STVBallot test_ballot(votes, ballotID);
+  EXPECT_EQ(test_ballot.getValue(), STVBallot::fullValue);
+
+  test_ballot.setValue(250000);
+  STVBallot copy(test_ballot);
+  EXPECT_EQ(copy.getValue(), 250000);
+
+  test_ballot.resetPreference();
+  EXPECT_EQ(test_ballot.getValue(), STVBallot::fullValue);
+}
+
+// Small contests keep the ranking inside a one cache line ballot
+TEST_F(STVBallotTest, InlineRankingTest) {
+  EXPECT_EQ(sizeof(STVBallot), 64u);
+  EXPECT_EQ(alignof(STVBallot), 64u);
+
+  votes = {3, 0, 1, 2};
+  STVBallot original(votes, ballotID);
+  std::vector<int> expected = {2, 3, 0};
+  STVBallot::Ranking ranking = original.getRanking();
+  EXPECT_EQ(std::vector<int>(ranking.begin(), ranking.end()), expected);
+
+  STVBallot copy(original);
+  original.advance(std::vector<bool>(votes.size(), false));
+  EXPECT_EQ(copy.getPreference(), 2);
+  STVBallot moved(std::move(copy));
+  ranking = moved.getRanking();
+  EXPECT_EQ(std::vector<int>(ranking.begin(), ranking.end()), expected);
+}
+
+// Larger contests spill the ranking, copies get their own
+TEST_F(STVBallotTest, SpilledRankingTest) {
+  const int numCandidates = STVBallot::inlineRanks + 4;
+  votes.assign(numCandidates, 0);
+  std::vector<int> expected;
+  for (int c = numCandidates - 1; c >= 0; c--) {
+    votes[c] = static_cast<int>(expected.size()) + 1;
+    expected.push_back(c);
+  }
+
+  std::vector<STVBallot> ballots;
+  ballots.emplace_back(votes, ballotID);
+  ballots.push_back(ballots.front());
+  ballots.push_back(std::move(ballots.front()));
+  ballots.front() = ballots.back();
+  for (const STVBallot &ballot : ballots) {
+    STVBallot::Ranking ranking = ballot.getRanking();
+    EXPECT_EQ(std::vector<int>(ranking.begin(), ranking.end()), expected);
+  }
+
+  std::vector<bool> excluded(numCandidates, false);
+  excluded[numCandidates - 1] = true;
+  excluded[numCandidates - 2] = true;
+  EXPECT_EQ(ballots[1].skipExcluded(excluded), numCandidates - 3);
+  EXPECT_EQ(ballots[2].getPreference(), numCandidates - 1);
+}
+
+// Store rows are validated by the loader, so a row view does not check
+// them again - only the vector constructor throws
+TEST_F(STVBallotTest, RowViewSkipsValidation) {
+  votes = {1, 0, 0, 0, 0, 2};
+  EXPECT_THROW(STVBallot(votes, ballotID), std::invalid_argument);
+
+  STVBallot row(votes.data(), static_cast<int>(votes.size()), ballotID);
+  EXPECT_EQ(row.getPreference(), 0);
+  STVBallot::Ranking ranking = row.getRanking();
+  EXPECT_EQ(std::vector<int>(ranking.begin(), ranking.end()),
+            (std::vector<int>{0, 5}));
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
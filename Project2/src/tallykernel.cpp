@@ -0,0 +1,130 @@
+/*
+ * File: tallykernel.cpp
+ * Description: Implements the scalar, SSE4.2 and AVX2 column-sum kernels and
+ *              the runtime choice between them.
+ */
+
+#include "tallykernel.h"
+#include <numeric>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TALLY_X86 1
+#include <immintrin.h>
+#endif
+
+namespace tally {
+
+namespace {
+
+void countScalar(const int *votes, std::size_t rows, std::size_t width,
+                 int *counts) {
+  for (std::size_t r = 0; r < rows; r++) {
+    const int *row = votes + r * width;
+    for (std::size_t c = 0; c < width; c++)
+      counts[c] += row[c] == 1;
+  }
+}
+
+// The SIMD kernels read the matrix as one flat array. Lane j of a period of
+// lcm(width, lanes) votes always lands on column j % width, so whole periods
+// are summed lane-wise into acc and folded back into the columns once; the
+// rows after the last whole period go through the scalar kernel.
+void foldPeriod(const std::vector<int> &acc, std::size_t width, int *counts) {
+  for (std::size_t j = 0; j < acc.size(); j++)
+    counts[j % width] += acc[j];
+}
+
+#ifdef TALLY_X86
+__attribute__((target("sse4.2"))) void
+countSSE42(const int *votes, std::size_t rows, std::size_t width, int *counts) {
+  const std::size_t period = std::lcm<std::size_t>(width, 4);
+  const std::size_t fullRows = rows - rows % (period / width);
+  std::vector<int> acc(period, 0);
+  const __m128i one = _mm_set1_epi32(1);
+
+  for (std::size_t i = 0; i < fullRows * width; i += period) {
+    for (std::size_t j = 0; j < period; j += 4) {
+      __m128i v =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(votes + i + j));
+      __m128i *sum = reinterpret_cast<__m128i *>(acc.data() + j);
+      // A matching lane compares to -1, so subtracting the mask adds 1
+      _mm_storeu_si128(sum, _mm_sub_epi32(_mm_loadu_si128(sum),
+                                          _mm_cmpeq_epi32(v, one)));
+    }
+  }
+  foldPeriod(acc, width, counts);
+  countScalar(votes + fullRows * width, rows - fullRows, width, counts);
+}
+
+__attribute__((target("avx2"))) void
+countAVX2(const int *votes, std::size_t rows, std::size_t width, int *counts) {
+  const std::size_t period = std::lcm<std::size_t>(width, 8);
+  const std::size_t fullRows = rows - rows % (period / width);
+  std::vector<int> acc(period, 0);
+  const __m256i one = _mm256_set1_epi32(1);
+
+  for (std::size_t i = 0; i < fullRows * width; i += period) {
+    for (std::size_t j = 0; j < period; j += 8) {
+      __m256i v =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(votes + i + j));
+      __m256i *sum = reinterpret_cast<__m256i *>(acc.data() + j);
+      _mm256_storeu_si256(sum, _mm256_sub_epi32(_mm256_loadu_si256(sum),
+                                                _mm256_cmpeq_epi32(v, one)));
+    }
+  }
+  foldPeriod(acc, width, counts);
+  countScalar(votes + fullRows * width, rows - fullRows, width, counts);
+}
+#endif
+
+Kernel detectKernel() {
+#ifdef TALLY_X86
+  if (__builtin_cpu_supports("avx2"))
+    return Kernel::AVX2;
+  if (__builtin_cpu_supports("sse4.2"))
+    return Kernel::SSE42;
+#endif
+  return Kernel::Scalar;
+}
+
+} // namespace
+
+Kernel bestKernel() {
+  static const Kernel best = detectKernel();
+  return best;
+}
+
+bool supported(Kernel kernel) {
+  return static_cast<int>(kernel) <= static_cast<int>(bestKernel());
+}
+
+const char *kernelName(Kernel kernel) {
+  switch (kernel) {
+  case Kernel::SSE42:
+    return "sse4.2";
+  case Kernel::AVX2:
+    return "avx2";
+  default:
+    return "scalar";
+  }
+}
+
+void countOnes(const int *votes, std::size_t rows, std::size_t width,
+               int *counts, Kernel kernel) {
+  if (width == 0)
+    return;
+#ifdef TALLY_X86
+  if (kernel == Kernel::AVX2) {
+    countAVX2(votes, rows, width, counts);
+    return;
+  }
+  if (kernel == Kernel::SSE42) {
+    countSSE42(votes, rows, width, counts);
+    return;
+  }
+#endif
+  countScalar(votes, rows, width, counts);
+}
+
+} // namespace tally
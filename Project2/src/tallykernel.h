@@ -0,0 +1,51 @@
+/*
+ * File: tallykernel.h
+ * Description: Column-sum kernels for PV and MV tallies - count the 1 marks
+ *              of every candidate column of a row-major vote matrix. SSE4.2
+ *              and AVX2 versions are picked at runtime when the CPU has them.
+ */
+
+#ifndef TALLYKERNEL_H
+#define TALLYKERNEL_H
+
+#include <cstddef>
+
+namespace tally {
+
+/**
+ * @brief instruction sets the column-sum kernel comes in
+ */
+enum class Kernel { Scalar, SSE42, AVX2 };
+
+/**
+ * @brief returns the fastest kernel this CPU supports, detected once
+ * @return AVX2, SSE42 or Scalar
+ */
+Kernel bestKernel();
+/**
+ * @brief returns true if this CPU can run the kernel
+ * @param kernel kernel to check
+ */
+bool supported(Kernel kernel);
+/**
+ * @brief returns a short name for the kernel
+ * @param kernel kernel to name
+ * @return "scalar", "sse4.2" or "avx2"
+ */
+const char *kernelName(Kernel kernel);
+
+/**
+ * @brief adds the number of votes equal to 1 in each column to counts
+ * Every kernel gives the same counts as the scalar one.
+ * @param votes rows x width votes, row-major
+ * @param rows number of rows
+ * @param width votes per row
+ * @param counts width counts to add to
+ * @param kernel kernel to run, must be supported by this CPU
+ */
+void countOnes(const int *votes, std::size_t rows, std::size_t width,
+               int *counts, Kernel kernel = bestKernel());
+
+} // namespace tally
+
+#endif // TALLYKERNEL_H
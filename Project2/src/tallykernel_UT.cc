@@ -0,0 +1,59 @@
+/*
+ * File: tallykernel_UT.cc
+ * Description: Unit tests for the column-sum tally kernels including:
+ *              - Every kernel this CPU supports matching the scalar kernel
+ *              - Row counts that leave a partial period at the end
+ *              - Only votes equal to 1 being counted
+ */
+
+#include "tallykernel.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+// Each supported kernel gives the scalar counts for narrow and wide rows
+TEST(TallyKernelTests, MatchesScalarTest) {
+  const tally::Kernel kernels[] = {tally::Kernel::SSE42, tally::Kernel::AVX2};
+  for (std::size_t width : {1, 3, 5, 8, 12, 37}) {
+    for (std::size_t rows : {0, 1, 7, 64, 1001}) {
+      std::mt19937 rng(static_cast<unsigned>(width * 10000 + rows));
+      std::vector<int> votes(rows * width);
+      for (int &v : votes)
+        v = static_cast<int>(rng() % 3); // 0, 1 and 2 so only 1s count
+
+      std::vector<int> expected(width, 0);
+      tally::countOnes(votes.data(), rows, width, expected.data(),
+                       tally::Kernel::Scalar);
+      for (tally::Kernel kernel : kernels) {
+        if (!tally::supported(kernel))
+          continue;
+        std::vector<int> counts(width, 0);
+        tally::countOnes(votes.data(), rows, width, counts.data(), kernel);
+        EXPECT_EQ(counts, expected) << tally::kernelName(kernel) << " width "
+                                    << width << " rows " << rows;
+      }
+    }
+  }
+}
+
+// Counts are added to what is already there
+TEST(TallyKernelTests, AddsToCountsTest) {
+  std::vector<int> votes = {1, 0, 1, //
+                            0, 1, 1, //
+                            2, 1, -1};
+  std::vector<int> counts = {10, 20, 30};
+  tally::countOnes(votes.data(), 3, 3, counts.data());
+  EXPECT_EQ(counts, (std::vector<int>{11, 22, 32}));
+}
+
+// The scalar kernel is always there and the best one is supported
+TEST(TallyKernelTests, DispatchTest) {
+  EXPECT_TRUE(tally::supported(tally::Kernel::Scalar));
+  EXPECT_TRUE(tally::supported(tally::bestKernel()));
+  EXPECT_STREQ(tally::kernelName(tally::Kernel::Scalar), "scalar");
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
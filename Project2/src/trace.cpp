@@ -0,0 +1,121 @@
+/*
+ * File: trace.cpp
+ * Description: Implements the trace sink - a file with a large stdio buffer,
+ *              shared by every thread behind a mutex.
+ */
+
+#include "trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
+namespace trace {
+
+namespace detail {
+std::atomic<unsigned> active[3];
+} // namespace detail
+
+namespace {
+
+constexpr std::size_t bufferBytes = 1 << 20;
+
+std::mutex sinkMutex;
+std::FILE *sink = nullptr;
+std::unique_ptr<char[]> buffer;
+
+std::string_view categoryName(Category category) {
+  switch (category) {
+  case Parse:
+    return "parse";
+  case Shuffle:
+    return "shuffle";
+  case Transfer:
+    return "transfer";
+  case Round:
+    return "round";
+  case Ballot:
+    return "ballot";
+  default:
+    return "trace";
+  }
+}
+
+// Lets the file close normally when main returns without calling close()
+void closeAtExit() { close(); }
+
+} // namespace
+
+bool open(const std::string &path, Level level, unsigned categories) {
+  close();
+  std::lock_guard<std::mutex> lock(sinkMutex);
+  std::FILE *file = std::fopen(path.c_str(), "w");
+  if (!file)
+    return false;
+  buffer = std::make_unique<char[]>(bufferBytes);
+  std::setvbuf(file, buffer.get(), _IOFBF, bufferBytes);
+  sink = file;
+
+  static std::once_flag registered;
+  std::call_once(registered, [] { std::atexit(closeAtExit); });
+
+  for (int l = 0; l < 3; l++)
+    detail::active[l].store(
+        l != 0 && l <= static_cast<int>(level) ? categories & All : 0,
+        std::memory_order_relaxed);
+  return true;
+}
+
+void close() {
+  for (auto &mask : detail::active)
+    mask.store(0, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(sinkMutex);
+  if (sink) {
+    std::fclose(sink);
+    sink = nullptr;
+  }
+  buffer.reset();
+}
+
+void write(Category category, std::string_view line) {
+  std::lock_guard<std::mutex> lock(sinkMutex);
+  if (!sink)
+    return;
+  std::string_view name = categoryName(category);
+  std::fputc('[', sink);
+  std::fwrite(name.data(), 1, name.size(), sink);
+  std::fputs("] ", sink);
+  std::fwrite(line.data(), 1, line.size(), sink);
+  std::fputc('\n', sink);
+}
+
+unsigned parseCategories(std::string_view list) {
+  unsigned flags = 0;
+  while (!list.empty()) {
+    std::size_t comma = list.find(',');
+    std::string_view name = list.substr(0, comma);
+    list = comma == std::string_view::npos ? std::string_view()
+                                           : list.substr(comma + 1);
+    if (name == "all")
+      flags |= All;
+    for (Category category : {Parse, Shuffle, Transfer, Round, Ballot})
+      if (name == categoryName(category))
+        flags |= category;
+  }
+  return flags;
+}
+
+bool openFromEnvironment() {
+  const char *categories = std::getenv("VOTING_TRACE");
+  if (!categories || !*categories)
+    return false;
+  const char *levelName = std::getenv("VOTING_TRACE_LEVEL");
+  Level level = levelName && std::string_view(levelName) == "debug"
+                    ? Level::Debug
+                    : Level::Info;
+  const char *path = std::getenv("VOTING_TRACE_FILE");
+  return open(path && *path ? path : "trace.log", level,
+              parseCategories(categories));
+}
+
+} // namespace trace
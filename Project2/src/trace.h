@@ -0,0 +1,116 @@
+/*
+ * File: trace.h
+ * Description: Structured tracing for the counting code. Trace points are
+ *              grouped by category (parse, ballot, shuffle, transfer, round) and
+ *              level, cost one branch while tracing is off and are compiled
+ *              out entirely with -DVOTING_NO_TRACE. Enabled points are
+ *              written to a buffered file, never to the console.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace trace {
+
+/**
+ * @brief how much detail a trace point carries
+ * Info is one line per step (a round, a transfer, a file); Debug may be one
+ * line per ballot.
+ */
+enum class Level { Off = 0, Info = 1, Debug = 2 };
+
+/**
+ * @brief the part of the count a trace point belongs to, as bit flags
+ */
+enum Category : unsigned {
+  Parse = 1u << 0,    // Reading and checking ballot files
+  Shuffle = 1u << 1,  // Ballot order after shuffling
+  Transfer = 1u << 2, // Surplus and elimination transfers
+  Round = 1u << 3,    // Elections, eliminations and the final result
+  Ballot = 1u << 4,   // Votes of each loaded ballot
+  All = Parse | Shuffle | Transfer | Round | Ballot
+};
+
+#ifdef VOTING_NO_TRACE
+inline constexpr bool compiled = false;
+#else
+inline constexpr bool compiled = true;
+#endif
+
+namespace detail {
+// Enabled categories for each level, filled by open()
+extern std::atomic<unsigned> active[3];
+} // namespace detail
+
+/**
+ * @brief tells whether a trace point would be written
+ * A single relaxed load and test while tracing is off.
+ * @param category category of the trace point
+ * @param level level of the trace point
+ */
+inline bool enabled(Category category, Level level) {
+  return compiled &&
+         (detail::active[static_cast<int>(level)].load(
+              std::memory_order_relaxed) &
+          category) != 0;
+}
+
+/**
+ * @brief starts tracing to a file, replacing any earlier sink
+ * @param path file to write, truncated
+ * @param level most detailed level written
+ * @param categories Category flags to write
+ * @return false if the file could not be opened, tracing stays off
+ */
+bool open(const std::string &path, Level level, unsigned categories);
+
+/**
+ * @brief flushes and closes the sink, tracing is off afterwards
+ */
+void close();
+
+/**
+ * @brief writes one line to the sink, thread-safe
+ * @param category category of the line, printed as its prefix
+ * @param line text without the trailing newline
+ */
+void write(Category category, std::string_view line);
+
+/**
+ * @brief parses a category list such as "shuffle,round" or "all"
+ * @param list comma separated category names
+ * @return Category flags, unknown names are ignored
+ */
+unsigned parseCategories(std::string_view list);
+
+/**
+ * @brief starts tracing from VOTING_TRACE, VOTING_TRACE_LEVEL and
+ *        VOTING_TRACE_FILE if VOTING_TRACE is set
+ * @return true if tracing was started
+ */
+bool openFromEnvironment();
+
+} // namespace trace
+
+/**
+ * @brief writes a trace line built with <<, e.g.
+ *        TRACE(trace::Round, trace::Level::Info, "elected " << name);
+ * The message is only built when the point is enabled, and with
+ * VOTING_NO_TRACE the condition is constant false so the whole point is
+ * dropped by the compiler while the message still type-checks.
+ */
+#define TRACE(category, level, message)                                        \
+  do {                                                                         \
+    if (trace::enabled(category, level)) {                                     \
+      std::ostringstream traceLine;                                            \
+      traceLine << message;                                                    \
+      trace::write(category, traceLine.str());                                 \
+    }                                                                          \
+  } while (0)
+
+#endif // TRACE_H
@@ -0,0 +1,134 @@
+/*
+ * File: trace_UT.cc
+ * Description: Unit tests for the trace subsystem (trace.cpp) including:
+ *              - Tracing off until a sink is opened
+ *              - Level and category filtering
+ *              - Category list parsing
+ *              - STV shuffle and round trace points
+ *              - Ballot allocation trace points
+ */
+
+#include "Election.h"
+#include "candidate.h"
+#include "stv.h"
+#include "stvballot.h"
+#include "trace.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::string tracePath = "trace_UT.log";
+
+std::string readTrace() {
+  std::ifstream in(tracePath);
+  std::stringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+} // namespace
+
+// Nothing is enabled, or written, without a sink
+TEST(TraceTests, OffByDefaultTest) {
+  trace::close();
+  EXPECT_FALSE(trace::enabled(trace::Round, trace::Level::Info));
+  EXPECT_FALSE(trace::enabled(trace::Parse, trace::Level::Debug));
+  trace::write(trace::Round, "dropped"); // no sink - ignored
+}
+
+// Only the chosen categories, at the chosen level or less, are written
+TEST(TraceTests, FilterTest) {
+  ASSERT_TRUE(trace::open(tracePath, trace::Level::Info,
+                          trace::Round | trace::Transfer));
+  EXPECT_TRUE(trace::enabled(trace::Round, trace::Level::Info));
+  EXPECT_TRUE(trace::enabled(trace::Transfer, trace::Level::Info));
+  EXPECT_FALSE(trace::enabled(trace::Round, trace::Level::Debug));
+  EXPECT_FALSE(trace::enabled(trace::Parse, trace::Level::Info));
+  EXPECT_FALSE(trace::enabled(trace::Round, trace::Level::Off));
+
+  int built = 0;
+  TRACE(trace::Round, trace::Level::Info, "round " << ++built);
+  TRACE(trace::Round, trace::Level::Debug, "hidden " << ++built);
+  TRACE(trace::Shuffle, trace::Level::Info, "hidden " << ++built);
+  trace::close();
+
+  EXPECT_EQ(readTrace(), "[round] round 1\n");
+  // Messages of disabled points are never built
+  EXPECT_EQ(built, 1);
+  EXPECT_FALSE(trace::enabled(trace::Round, trace::Level::Info));
+  std::remove(tracePath.c_str());
+}
+
+TEST(TraceTests, ParseCategoriesTest) {
+  EXPECT_EQ(trace::parseCategories("shuffle,round"),
+            unsigned{trace::Shuffle | trace::Round});
+  EXPECT_EQ(trace::parseCategories("all"), unsigned{trace::All});
+  EXPECT_EQ(trace::parseCategories("parse,bogus,"), unsigned{trace::Parse});
+  EXPECT_EQ(trace::parseCategories("ballot"), unsigned{trace::Ballot});
+  EXPECT_EQ(trace::parseCategories(""), 0u);
+}
+
+// The ballot order only goes to the trace, one line per ballot at Debug,
+// and elections and eliminations are traced as rounds
+TEST(TraceTests, STVTraceTest) {
+  std::vector<Candidate *> cands = {new Candidate("A", 0), new Candidate("B", 1),
+                                    new Candidate("C", 2)};
+  std::vector<Ballot *> ranked = {
+      new STVBallot({1, 2, 3}, 1), new STVBallot({1, 3, 2}, 2),
+      new STVBallot({2, 1, 3}, 3), new STVBallot({3, 2, 1}, 4),
+      new STVBallot({3, 1, 2}, 5)};
+
+  ASSERT_TRUE(trace::open(tracePath, trace::Level::Debug,
+                          trace::Shuffle | trace::Round));
+  STV stv(ranked, cands, 1);
+  std::vector<Candidate *> winners, losers;
+  testing::internal::CaptureStdout();
+  stv.runElection(winners, losers);
+  EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+  trace::close();
+
+  std::string text = readTrace();
+  EXPECT_NE(text.find("[shuffle] ballot 1 -> 1 2 3\n"), std::string::npos);
+  EXPECT_NE(text.find("[shuffle] ballot 5 -> 3 1 2\n"), std::string::npos);
+  // Nobody reaches the quota of 3 on first preferences, so C goes and
+  // its ballot elects B
+  EXPECT_NE(text.find("[round] eliminated C with 1 votes"), std::string::npos);
+  EXPECT_NE(text.find("[round] elected B"), std::string::npos);
+  EXPECT_NE(text.find("[round] winner B: 3 votes"), std::string::npos);
+  EXPECT_EQ(text.find("[transfer]"), std::string::npos);
+  std::remove(tracePath.c_str());
+
+  for (auto *b : ranked) delete b;
+  for (auto *c : cands) delete c;
+}
+
+// The votes of every loaded ballot go to the trace, never to the console
+TEST(TraceTests, BallotTraceTest) {
+  Election election({"../../testing/stv_ballots.csv"}, "STV", 2);
+  election.setBallots();
+
+  testing::internal::CaptureStdout();
+  election.displayBallotAllocation();
+  ASSERT_TRUE(trace::open(tracePath, trace::Level::Info, trace::Ballot));
+  election.displayBallotAllocation();
+  trace::close();
+  ASSERT_TRUE(trace::open(tracePath, trace::Level::Debug, trace::Ballot));
+  election.displayBallotAllocation();
+  trace::close();
+  EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+
+  std::string text = readTrace();
+  EXPECT_EQ(text.find("[ballot] ballot 1 -> 1 0 2 0 3\n"), 0u);
+  EXPECT_NE(text.find("[ballot] ballot 2 -> 3 2 1 4 6\n"), std::string::npos);
+  std::remove(tracePath.c_str());
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -3,7 +3,7 @@
  * File: userinterface.cpp
  * Description: Implements the user interface. Handles user input for election configuration including:
  *              - Number of csv files entered
- *              - CSV file input/validation
+ *              - CSV and binary ballot file input/validation
  *              - Extracting Election parameters from CSV files
  *              - Entering Audit file name
  * Author: Anwesha Samaddar & Annabelle Coler
@@ -18,6 +18,7 @@
 #include <filesystem>
 #include <sstream>
 #include "stv.h"
+#include "ballotfile.h"
 
 using namespace std;
 
@@ -65,9 +66,12 @@ void UserInterface::getInfo() {
             cout << "Enter CSV file #" << (i+1) << ": ";
             cin >> filename;
 
-            // Validate file extension
-            if (filename.size() < 4 || filename.substr(filename.size() - 4) != ".csv") {
-                cout << "Error: File must be a CSV file with .csv extension." << endl;
+            // Validate file extension - CSV, or a ballot file made by csv2ballot
+            const bool ballotFile = filename.size() >= 7 &&
+                                    filename.substr(filename.size() - 7) == ".ballot";
+            if (!ballotFile &&
+                (filename.size() < 4 || filename.substr(filename.size() - 4) != ".csv")) {
+                cout << "Error: File must be a CSV file with .csv extension or a .ballot file." << endl;
                 attempts++;
                 continue;
             }
@@ -80,10 +84,26 @@ void UserInterface::getInfo() {
             } else {
                 // Read file contents 
                 string line;
-                getline(file, line);
                 string currentAlgorithm;  // get election type
-                istringstream iss(line);
-                getline(iss, currentAlgorithm, ',');
+                int currentSeats = 0;
+                if (ballotFile) {
+                    // Election type and seats are in the ballot file header
+                    try {
+                        BallotFile ballots(filename);
+                        currentAlgorithm = ballots.algorithm();
+                        currentSeats = ballots.seats();
+                    } catch (const std::runtime_error& e) {
+                        cout << "Error: " << e.what() << endl;
+                        attempts++;
+                        continue;
+                    }
+                } else {
+                    getline(file, line);
+                    istringstream iss(line);
+                    getline(iss, currentAlgorithm, ',');
+                    getline(file, line);
+                    currentSeats = stoi(line);
+                }
 
                 // For first file, set algorithm and seats
                 if (i == 0) {
@@ -94,8 +114,7 @@ void UserInterface::getInfo() {
                     }
                     
                     // Read number of seats
-                    getline(file, line);
-                    numSeats = stoi(line);
+                    numSeats = currentSeats;
                 } 
                 // For subsequent files, verify consistency - if algorithm type and number of seats do not match, throw error messages
                 else {
@@ -104,8 +123,7 @@ void UserInterface::getInfo() {
                         attempts++;
                         continue;
                     }
-                    getline(file, line);
-                    if (stoi(line) != numSeats) {
+                    if (currentSeats != numSeats) {
                         cout << "Error: Number of seats doesn't match first file." << endl;
                         attempts++;
                         continue;